@@ -75,6 +75,15 @@ MAKEFILE_STACK := $(filter-out $(lastword $(MAKEFILE_STACK)), $(MAKEFILE_STACK))
 #   build mode, for library directories
 # - "LIBS_{ALL,DBG,PRF,REL,X86,A64,X86_DBG,X86_PRF,X86_REL,A64_DBG,A64_PRF,A64_REL} for libraries
 
+# heap allocation counter of "-fpbench", see "src/allocationCounter.h"
+# user note: Off by default, as it replaces glibc's allocator of the whole executable, including flights, and clashes
+#            with sanitizers, tcmalloc and jemalloc. Build a benchmarking binary via "make clean" followed by
+#            "make COUNT_HEAP_ALLOCATIONS=1".
+COUNT_HEAP_ALLOCATIONS ?= 0
+ifeq ($(COUNT_HEAP_ALLOCATIONS),1)
+   DEFS += -DDEMOARDRONE_COUNT_HEAP_ALLOCATIONS
+endif
+
 # adapted version of Andreas Geiger's visual odometry library
 INC_DIRS += -I$(REL_DIR)src/libviso2
 
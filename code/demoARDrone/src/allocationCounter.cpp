@@ -0,0 +1,116 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// process-wide count of heap allocations
+// ======================================
+
+#include "allocationCounter.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#if defined( __GLIBC__ ) && defined( DEMOARDRONE_COUNT_HEAP_ALLOCATIONS )
+#define INTERPOSE_ALLOCATOR
+#include <malloc.h>
+#endif
+
+// counter shared by all threads
+// developer note: Constant-initialized, so it is valid even for allocations during static initialization.
+namespace {
+std::atomic< size_t > allocations( 0 ) ;
+} // anonymous namespace
+
+// number of heap allocations since program start
+size_t heapAllocations() {
+	return allocations.load( std::memory_order_relaxed ) ;
+}
+
+// whether allocations are counted at all
+bool heapAllocationsCounted() {
+	#if defined( INTERPOSE_ALLOCATOR )
+	return true ;
+	#else
+	return false ;
+	#endif
+}
+
+// replacements of glibc's allocation functions, forwarding to its implementation after counting
+// developer note: glibc exports its allocator under "__libc_*" names for exactly this purpose. All functions share its
+//                 heap, so memory may still be released by any of them - "free()" is replaced only because glibc
+//                 requires "malloc()", "free()", "calloc()" and "realloc()" to be replaced together. Sanitizers,
+//                 tcmalloc or jemalloc replace the same functions, so do not combine them with this.
+#if defined( INTERPOSE_ALLOCATOR )
+extern "C" {
+
+void* __libc_malloc(   size_t size ) ;
+void* __libc_calloc(   size_t count, size_t size ) ;
+void* __libc_realloc(  void*  ptr,   size_t size ) ;
+void* __libc_memalign( size_t alignment, size_t size ) ;
+void* __libc_valloc(   size_t size ) ;
+void* __libc_pvalloc(  size_t size ) ;
+void  __libc_free(     void*  ptr ) ;
+
+void* malloc( size_t size ) __THROW {
+	allocations.fetch_add( 1, std::memory_order_relaxed ) ;
+	return __libc_malloc( size ) ;
+}
+
+void* calloc( size_t count, size_t size ) __THROW {
+	allocations.fetch_add( 1, std::memory_order_relaxed ) ;
+	return __libc_calloc( count, size ) ;
+}
+
+void* realloc( void* ptr, size_t size ) __THROW {
+	allocations.fetch_add( 1, std::memory_order_relaxed ) ;
+	return __libc_realloc( ptr, size ) ;
+}
+
+void* memalign( size_t alignment, size_t size ) __THROW {
+	allocations.fetch_add( 1, std::memory_order_relaxed ) ;
+	return __libc_memalign( alignment, size ) ;
+}
+
+void* aligned_alloc( size_t alignment, size_t size ) __THROW {
+	allocations.fetch_add( 1, std::memory_order_relaxed ) ;
+	return __libc_memalign( alignment, size ) ;
+}
+
+void* valloc( size_t size ) __THROW {
+	allocations.fetch_add( 1, std::memory_order_relaxed ) ;
+	return __libc_valloc( size ) ;
+}
+
+void* pvalloc( size_t size ) __THROW {
+	allocations.fetch_add( 1, std::memory_order_relaxed ) ;
+	return __libc_pvalloc( size ) ;
+}
+
+int posix_memalign( void** ptr, size_t alignment, size_t size ) __THROW {
+	if( alignment % sizeof( void* ) != 0 || ( alignment & ( alignment - 1 ) ) != 0 || alignment == 0 ) {
+		return EINVAL ;
+	}
+	allocations.fetch_add( 1, std::memory_order_relaxed ) ;
+	void* const memory = __libc_memalign( alignment, size ) ;
+	if( memory == NULL ) { return ENOMEM ; }
+	*ptr = memory ;
+	return 0 ;
+}
+
+void free( void* ptr ) __THROW {
+	__libc_free( ptr ) ;
+}
+
+} // extern "C"
+#endif
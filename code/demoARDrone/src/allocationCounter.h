@@ -0,0 +1,34 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// process-wide count of heap allocations
+// ======================================
+
+#pragma once
+
+#include <cstddef>
+
+// number of heap allocations of all threads since program start: Calls of "malloc()", "calloc()", "realloc()",
+//                                                                 "posix_memalign()", "memalign()", "aligned_alloc()",
+//                                                                 "valloc()" and "pvalloc()" are counted by interposing
+//                                                                 glibc's allocator, so C++ "new" and the buffers of
+//                                                                 "cv::Mat" are included.
+// user note #1: Take differences of two calls, e.g. around processing an image.
+// user note #2: Interposing replaces the allocator of the whole executable, so it is only compiled in when building
+//               with "make COUNT_HEAP_ALLOCATIONS=1" (see "config.mk"), never for flights. Otherwise, or without glibc,
+//               the count stays zero and "heapAllocationsCounted()" returns "false".
+size_t heapAllocations() ;
+bool   heapAllocationsCounted() ;
@@ -21,6 +21,7 @@
 // ================
 
 #include "appDevel.h"
+#include "visualSink.h"
 #include "mydemo/ImageProcessing/imageProcessing.h"
 #include "hawaii/common/optimization.h"
 #include "hawaii/common/helpers.h"
@@ -60,7 +61,7 @@ void DroneAppDevel::processImageFront( const cv_bridge::CvImage imageFront ) {
 //	cv::gpu::cvtColor( imageBGR, imageGray.writeGPU( imageBGR.size(), CV_8UC1 ), cv::COLOR_BGR2GRAY ) ; // TODO profile
 	cv::GaussianBlur(      imageGray, imageGraySmooth.writeCPU( imageBGR.size(), CV_8UC1 ), cv::Size( 3, 3 ), 0.0, 0.0 ) ; // TODO multi-core
 //	cv::gpu::GaussianBlur( imageGray, imageGraySmooth.writeGPU( imageBGR.size(), CV_8UC1 ), cv::Size( 3, 3 ), 0.0, 0.0 ) ; // TODO profile
-	cv::imshow("asd", visualization);
+	VisualSink::instance().show( "asd", visualization ) ;
 	// go through sub-modules with decreasing priority
 	bool commandsSet = false ;
 	
@@ -110,9 +111,8 @@ void DroneAppDevel::processImageFront( const cv_bridge::CvImage imageFront ) {
 	if( 1
 	 || this->keystates[ SDLK_v ]
 	 || this->buttons[ buttonBlue ] ) {
-		HAWAII_IMSHOW( visualization ) ;
+		VISUAL_SHOW( visualization ) ;
 	}
-	cv::waitKey( 1 ) ;
 }
 
 // process keystrokes and gamepad input
@@ -20,6 +20,7 @@
 // ================
 
 #include "appDevelFP.h"
+#include "visualSink.h"
 #include "mydemo/ImageProcessing/imageProcessing.h"
 #include "hawaii/common/optimization.h"
 #include "hawaii/common/helpers.h"
@@ -103,9 +104,8 @@ void DroneAppDevelFP::processImageFront( const cv_bridge::CvImage imageFront ) {
 	if( 1
 	 || this->keystates[ SDLK_v ]
 	 || this->buttons[ buttonBlue ] ) {
-		HAWAII_IMSHOW( visualization ) ;
+		VISUAL_SHOW( visualization ) ;
 	}
-	cv::waitKey( 1 ) ;
 }
 
 // process keystrokes and gamepad input ???????? NEED 
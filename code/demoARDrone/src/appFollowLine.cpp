@@ -21,6 +21,7 @@
 // ===============================
 
 #include "appFollowLine.h"
+#include "visualSink.h"
 #include "hawaii/common/helpers.h"
 #include <opencv2/imgproc/imgproc.hpp>
 #include <SDL/SDL_keysym.h>
@@ -113,9 +114,8 @@ void DroneAppFollowLine::processImageBottom( const cv_bridge::CvImage imageBotto
 	}
 	
 	// show input and line visualization
-	HAWAII_IMSHOW( imageBottom.image ) ;
-	HAWAII_IMSHOW( visualization ) ;
-	cv::waitKey( 1 ) ;
+	VISUAL_SHOW( imageBottom.image ) ;
+	VISUAL_SHOW( visualization ) ;
 	
 	// increase height if line is far away or if not found at all
 	this->targetHeight = std::min( 1.5, found ?
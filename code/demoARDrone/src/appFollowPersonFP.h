@@ -22,10 +22,12 @@
 #pragma once
 
 #include "commands.h"
+#include "personTracker.h"
 #include "hawaii/common/timer.h"
 #include "hawaii/common/tracker.h"
 #include <opencv2/core/core.hpp>
 #include <memory>
+#include <string>
 
 class VisualOdometryMono;
 
@@ -35,13 +37,16 @@ class appFollowPersonFP {
 	// c'tor with camera properties
 	// user note: Before passing images, you need to undistort and stretch them such that the focal lengths along the u- 
 	//            and v-axes are identical. "DroneAppBase" already does that.
+	// user note: "dumpRoot" and "seed" are passed on to "PersonTracker", e.g. to replay recordings reproducibly.
 	public:
-	appFollowPersonFP( const double focalLength,
-	          const double principalPointU,
-	          const double principalPointV ) ;
+	appFollowPersonFP( const double       focalLength,
+	                   const double       principalPointU,
+	                   const double       principalPointV,
+	                   const std::string& dumpRoot = "/home/drone/repos",
+	                   const unsigned int seed     = 0 ) ;
 	
 	protected:
-
+	
 	
 	// process the latest image, together with the drone's on-board odometry pose at the time is was captured
 	// user note: If available, pass a grayscale image to avoid internal conversion.
@@ -53,9 +58,44 @@ class appFollowPersonFP {
 	cv::Size sizeImage ;
 	double scaleFactor ;
 	
+	// person detection and tracking, persistent across images
+	public:
+	const PersonTracker& getPersonTracker() const { return this->personTracker ; }
+	protected:
+	PersonTracker personTracker ;
+	
+	// detection scheduling: Run HOG on every "detectEvery"-th image, and on every image while the person is not found,
+	//                       the particle set's effective sample size is below "neffMin", the SVM score of the latest
+	//                       detection is below "scoreMin" or the color appearance at the estimate is less similar than
+	//                       "similarityMin". In between, track via color appearance and derive commands from that.
+	// user note: Set "detectEvery" to 1 to run HOG on every image. The counters tell how many images took which path.
+	public:
+	int    detectEvery ;
+	float  neffMin ;
+	double scoreMin ;
+	float  similarityMin ;
+	size_t countDetectFull,
+	       countDetectMotion,
+	       countDetectROI,
+	       countPredict ;
+	protected:
+	int    framesSinceDetection ;
+	
+	// distance control: The range to the followed person is derived from the tracked height of its detection box, the
+	//                   drone approaches while it is farther than "rangeFollow" meters
+	// user note: A HOG detection box is about 4/3 as high as the person in it, hence the default of "boxHeight".
+	public:
+	double boxHeight ;   // height of a detection box around a person in meters
+	double rangeFollow ;
+	double getRange()     const { return this->range ; }
+	double getRangeRate() const { return this->rangeRate ; }
+	protected:
+	double range,        // latest range estimate in meters, zero if none
+	       rangeRate ;   // its change per image in meters
+	
 	// get control commands: See flight parameters above. Vertical and sideways motion are always set - therefore "true" 
 	//                       is always returned. Forward and yaw motion occur only after successful 3D reconstruction.
-		
+	
 	public:
 	
 	bool getCommands(DroneCommands& commands, const cv::Vec3d rotationGlobal,
@@ -91,5 +131,5 @@ class appFollowPersonFP {
        cv::Vec3d start_translation;
        short img_taken;
        //-----------------------variable for drift computation-------------------------//	
-	
+
 } ; // class "appFollowPersonFP"
@@ -24,6 +24,7 @@
 
 #include "appBase.h"
 #include "appDevel.h"
+#include "visualSink.h"
 #include "hawaii/common/tracker.h"
 #include "hawaii/common/helpers.h" //ADDTION MADE
 #include <opencv2/imgproc/imgproc.hpp>
@@ -63,9 +64,7 @@ class DroneAppFollowTag : public DroneAppBase {
 		Result = convert.str(); // set 'Result' to the contents of the stream
 		imwrite( "/home/drone/repos/code/demoARDrone/src/mydemo/"+Result+".jpg", visualization );
 		counter ++;
-		HAWAII_IMSHOW( visualization ) ;
-		
-		cv::waitKey( 1 );
+		VISUAL_SHOW( visualization ) ;
                 // printf("VISUALIZATION IS SHOWED");
 		}
 	// rely on drone SDK's tag detection, therefore only use "navdata"
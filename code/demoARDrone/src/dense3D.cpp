@@ -22,6 +22,7 @@
 
 #include "dense3D.h"
 #include "odometryDrone.h"
+#include "visualSink.h"
 #include "hawaii/common/helpers.h"
 #include "hawaii/common/error.h"
 #include "viso_mono.h"
@@ -335,12 +336,12 @@ void Dense3D::computeResults() {
 	fileStorage.release() ;
 	
 	// show the buffered images
-	HAWAII_IMSHOW( this->imagesBefore[ 0 ] ) ;
-	HAWAII_IMSHOW( this->imagesBefore[ 1 ] ) ;
-	HAWAII_IMSHOW( this->imagesBefore[ 2 ] ) ;
-	HAWAII_IMSHOW( this->imagesAfter[  0 ] ) ;
-	HAWAII_IMSHOW( this->imagesAfter[  1 ] ) ;
-	HAWAII_IMSHOW( this->imagesAfter[  2 ] ) ; //*/
+	VISUAL_SHOW( this->imagesBefore[ 0 ] ) ;
+	VISUAL_SHOW( this->imagesBefore[ 1 ] ) ;
+	VISUAL_SHOW( this->imagesBefore[ 2 ] ) ;
+	VISUAL_SHOW( this->imagesAfter[  0 ] ) ;
+	VISUAL_SHOW( this->imagesAfter[  1 ] ) ;
+	VISUAL_SHOW( this->imagesAfter[  2 ] ) ; //*/
 	
 	// change state when done
 	this->state = stateInactive ;
@@ -439,7 +440,7 @@ void Dense3D::visoProcess( const cv::Mat   imageDuring,
 			          cv::Point( match.u1p, match.v1p ),
 			          cv::Scalar( 0, 127, 255 ), 2, 4 ) ;
 		}
-		HAWAII_IMSHOW( visu ) ; //*/
+		VISUAL_SHOW( visu ) ; //*/
 		
 	} else {
 		
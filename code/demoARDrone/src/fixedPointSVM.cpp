@@ -0,0 +1,201 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// linear SVM on quantized HOG blocks with SIMD multiply-add
+// ==========================================================
+
+#include "fixedPointSVM.h"
+#include "hawaii/common/error.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ )
+	#define FIXED_POINT_SVM_X86
+	#include <immintrin.h>
+#endif
+
+// helpers only used here
+namespace {
+
+// number of SIMD lanes each quantized block is padded to, i.e. one SSE2 register of "int16_t"
+const int padding = 8 ;
+
+// block values in [0,1] are quantized to [0,4096], leaving headroom for the weights within 32 bit accumulation
+const float scaleBlocksDefault = 4096.0f ;
+
+// portable fallback
+int32_t windowDotScalar( const int16_t*       blockFirst,
+                         const std::ptrdiff_t strideX,
+                         const std::ptrdiff_t strideY,
+                         const int16_t*       weights,
+                         const int            blocksX,
+                         const int            blocksY,
+                         const int            blockStride ) {
+	int32_t sum = 0 ;
+	for( int blockX = 0 ; blockX < blocksX ; ++blockX ) {
+	for( int blockY = 0 ; blockY < blocksY ; ++blockY, weights += blockStride ) {
+		const int16_t* const block = blockFirst + blockX * strideX + blockY * strideY ;
+		for( int index = 0 ; index < blockStride ; ++index ) {
+			sum += (int32_t)block[ index ] * weights[ index ] ;
+		}
+	} }
+	return sum ;
+}
+
+#if defined( FIXED_POINT_SVM_X86 )
+
+// 8 values per "pmaddwd"
+__attribute__(( target( "sse2" ) ))
+int32_t windowDotSSE2( const int16_t*       blockFirst,
+                       const std::ptrdiff_t strideX,
+                       const std::ptrdiff_t strideY,
+                       const int16_t*       weights,
+                       const int            blocksX,
+                       const int            blocksY,
+                       const int            blockStride ) {
+	__m128i sum = _mm_setzero_si128() ;
+	for( int blockX = 0 ; blockX < blocksX ; ++blockX ) {
+	for( int blockY = 0 ; blockY < blocksY ; ++blockY, weights += blockStride ) {
+		const int16_t* const block = blockFirst + blockX * strideX + blockY * strideY ;
+		for( int index = 0 ; index < blockStride ; index += 8 ) {
+			sum = _mm_add_epi32( sum, _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)( block   + index ) ),
+			                                          _mm_loadu_si128( (const __m128i*)( weights + index ) ) ) ) ;
+		}
+	} }
+	sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) ) ;
+	sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) ) ;
+	return _mm_cvtsi128_si32( sum ) ;
+}
+
+// 16 values per "vpmaddwd", remainder of 8 via SSE2
+__attribute__(( target( "avx2" ) ))
+int32_t windowDotAVX2( const int16_t*       blockFirst,
+                       const std::ptrdiff_t strideX,
+                       const std::ptrdiff_t strideY,
+                       const int16_t*       weights,
+                       const int            blocksX,
+                       const int            blocksY,
+                       const int            blockStride ) {
+	__m256i sum256 = _mm256_setzero_si256() ;
+	__m128i sum128 = _mm_setzero_si128() ;
+	for( int blockX = 0 ; blockX < blocksX ; ++blockX ) {
+	for( int blockY = 0 ; blockY < blocksY ; ++blockY, weights += blockStride ) {
+		const int16_t* const block = blockFirst + blockX * strideX + blockY * strideY ;
+		int index = 0 ;
+		for( ; index + 16 <= blockStride ; index += 16 ) {
+			sum256 = _mm256_add_epi32( sum256, _mm256_madd_epi16( _mm256_loadu_si256( (const __m256i*)( block   + index ) ),
+			                                                      _mm256_loadu_si256( (const __m256i*)( weights + index ) ) ) ) ;
+		}
+		for( ; index < blockStride ; index += 8 ) {
+			sum128 = _mm_add_epi32( sum128, _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)( block   + index ) ),
+			                                                _mm_loadu_si128( (const __m128i*)( weights + index ) ) ) ) ;
+		}
+	} }
+	__m128i sum = _mm_add_epi32( sum128, _mm_add_epi32( _mm256_castsi256_si128( sum256 ),
+	                                                    _mm256_extracti128_si256( sum256, 1 ) ) ) ;
+	sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) ) ;
+	sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) ) ;
+	return _mm_cvtsi128_si32( sum ) ;
+}
+
+#endif // FIXED_POINT_SVM_X86
+
+} // anonymous namespace
+
+// c'tor with SVM weights and window geometry, build the quantized weight table and choose the kernel
+FixedPointSVM::FixedPointSVM( const std::vector< float >& weights,
+                              const int                   blockSizeArg,
+                              const int                   windowBlocksXArg,
+                              const int                   windowBlocksYArg ) :
+	blockSize( blockSizeArg ),
+	blockStrideValue( ( blockSizeArg + padding - 1 ) / padding * padding ),
+	windowBlocksX( windowBlocksXArg ),
+	windowBlocksY( windowBlocksYArg ),
+	scaleBlocks( scaleBlocksDefault ),
+	scaleWeights( 1.0f ),
+	scaleScore( 1.0 ),
+	kernel( windowDotScalar ),
+	kernelNameValue( "scalar" ) {
+	
+	// check input
+	const int blocksCount = this->windowBlocksX * this->windowBlocksY ;
+	HAWAII_ERROR_CONDITIONAL( this->blockSize <= 0 || blocksCount <= 0,
+	                          "Block size and window geometry must be positive." ) ;
+	HAWAII_ERROR_CONDITIONAL( weights.size() != (size_t)blocksCount * this->blockSize,
+	                          "Number of SVM weights does not match the window geometry." ) ;
+	
+	// largest weight scale such that no window score can exceed 32 bits: By Cauchy-Schwarz, a window's score is bounded
+	// by the norm of its quantized blocks times that of the quantized weights.
+	// developer note: Each quantized block's norm is at most its scale plus half a step per value due to rounding.
+	float weightMax = 0.0f ;
+	for( const float weight : weights ) { weightMax = std::max( weightMax, std::abs( weight ) ) ; }
+	HAWAII_ERROR_CONDITIONAL( weightMax == 0.0f,
+	                          "SVM weights must not all be zero." ) ;
+	const double normBlocks    = std::sqrt( (double)blocksCount )
+	                           * ( this->scaleBlocks + 0.5 * std::sqrt( (double)this->blockSize ) ),
+	             scoreLimit    = (double)std::numeric_limits< int32_t >::max() ;
+	this->scaleWeights = (float)( std::numeric_limits< int16_t >::max() / weightMax ) ;
+	this->weightsFixed.assign( (size_t)blocksCount * this->blockStrideValue, 0 ) ;
+	while( true ) {
+		double normWeights = 0.0 ;
+		for( int block = 0 ; block < blocksCount ; ++block ) {
+			for( int index = 0 ; index < this->blockSize ; ++index ) {
+				const int16_t weight = (int16_t)std::lround( weights[ block * this->blockSize + index ] * this->scaleWeights ) ;
+				this->weightsFixed[ block * this->blockStrideValue + index ] = weight ;
+				normWeights += (double)weight * weight ;
+			}
+		}
+		if( normBlocks * std::sqrt( normWeights ) <= scoreLimit ) { break ; }
+		this->scaleWeights *= 0.9f ;
+	}
+	this->scaleScore = 1.0 / ( (double)this->scaleBlocks * this->scaleWeights ) ;
+	
+	// fastest kernel the CPU supports
+	#if defined( FIXED_POINT_SVM_X86 )
+	__builtin_cpu_init() ;
+	if( __builtin_cpu_supports( "avx2" ) ) {
+		this->kernel          = windowDotAVX2 ;
+		this->kernelNameValue = "AVX2" ;
+	}
+	else if( __builtin_cpu_supports( "sse2" ) ) {
+		this->kernel          = windowDotSSE2 ;
+		this->kernelNameValue = "SSE2" ;
+	}
+	#endif
+}
+
+// quantize normalized blocks
+void FixedPointSVM::quantize( const float*   blocks,
+                              const int      count,
+                                    int16_t* blocksFixed ) const {
+	const float valueMax = (float)std::numeric_limits< int16_t >::max() ;
+	for( int block = 0 ; block < count ; ++block ) {
+		const float* const source = blocks      + block * this->blockSize ;
+		int16_t*     const target = blocksFixed + block * this->blockStrideValue ;
+		for( int index = 0 ; index < this->blockSize ; ++index ) {
+			target[ index ] = (int16_t)std::min( source[ index ] * this->scaleBlocks + 0.5f, valueMax ) ;
+		}
+		std::fill( target + this->blockSize, target + this->blockStrideValue, (int16_t)0 ) ;
+	}
+}
+
+// score of a window without bias
+double FixedPointSVM::score( const int16_t*       blockFirst,
+                             const std::ptrdiff_t strideX,
+                             const std::ptrdiff_t strideY ) const {
+	return this->kernel( blockFirst, strideX, strideY, &this->weightsFixed[ 0 ],
+	                     this->windowBlocksX, this->windowBlocksY, this->blockStrideValue ) * this->scaleScore ;
+}
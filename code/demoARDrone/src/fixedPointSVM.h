@@ -0,0 +1,90 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// linear SVM on quantized HOG blocks with SIMD multiply-add
+// ==========================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// linear SVM evaluated in 16 bit fixed point: The weights are quantized once into a table laid out in the order in
+//                                            which a window visits its blocks, each block padded to a multiple of 8
+//                                            values. Window scores are then computed via "pmaddwd" with 32 bit
+//                                            accumulation, using AVX2 or SSE2 depending on the CPU at run-time.
+// user note #1: Block values must be L2-normalized, as done by HOG, such that each of them is within [0,1].
+// user note #2: The weight scale is chosen such that no window score can overflow the 32 bit accumulators, given that
+//               each block has unit norm. Precision thus depends on the spread of the weights rather than saturating.
+class FixedPointSVM {
+	
+	// c'tor with SVM weights (without bias) ordered like a window visits its blocks, and the window geometry in blocks
+	public:
+	FixedPointSVM( const std::vector< float >& weights,
+	               const int                   blockSizeArg,
+	               const int                   windowBlocksXArg,
+	               const int                   windowBlocksYArg ) ;
+	
+	// number of "int16_t" per quantized block, including padding
+	public:
+	int blockStride() const { return this->blockStrideValue ; }
+	
+	// quantize "count" consecutive normalized blocks into "blocksFixed", which must hold "count * blockStride()" values
+	public:
+	void quantize( const float*   blocks,
+	               const int      count,
+	                     int16_t* blocksFixed ) const ;
+	
+	// score of a window without bias, given its top-left block and the distances between horizontally and vertically
+	// neighboring blocks in "int16_t"
+	// user note: Blocks are visited column-major, i.e. with "strideY" in the inner loop, like "cv::HOGDescriptor" does.
+	public:
+	double score( const int16_t*       blockFirst,
+	              const std::ptrdiff_t strideX,
+	              const std::ptrdiff_t strideY ) const ;
+	
+	// instruction set chosen at run-time, for diagnostics
+	public:
+	const char* kernelName() const { return this->kernelNameValue ; }
+	
+	// geometry and scales
+	protected:
+	int    blockSize,
+	       blockStrideValue,
+	       windowBlocksX,
+	       windowBlocksY ;
+	float  scaleBlocks,
+	       scaleWeights ;
+	double scaleScore ; // converts an accumulated score back to the float domain
+	
+	// quantized weights, one padded block after another in visiting order
+	protected:
+	std::vector< int16_t > weightsFixed ;
+	
+	// dot product of a whole window, dispatched once in the c'tor
+	protected:
+	typedef int32_t (*Kernel)( const int16_t*       blockFirst,
+	                           const std::ptrdiff_t strideX,
+	                           const std::ptrdiff_t strideY,
+	                           const int16_t*       weights,
+	                           const int            blocksX,
+	                           const int            blocksY,
+	                           const int            blockStride ) ;
+	Kernel      kernel ;
+	const char* kernelNameValue ;
+
+} ; // class "FixedPointSVM"
@@ -0,0 +1,282 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// off-line benchmark of the follow-person pipeline on recorded frames
+// ===================================================================
+
+#include "allocationCounter.h"
+#include "appFollowPersonFP.h"
+#include "commands.h"
+#include "visualSink.h"
+#include "hawaii/common/error.h"
+#include <opencv2/highgui/highgui.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+
+// helpers only used here
+namespace {
+
+// milliseconds since a tick count
+double millisecondsSince( const int64 ticksStart ) {
+	return ( cv::getTickCount() - ticksStart ) * 1000.0 / cv::getTickFrequency() ;
+}
+
+// nearest-rank percentile of a set of samples, zero if empty
+double percentile( std::vector< double > samples,
+                   const double          rank ) {
+	if( samples.empty() ) { return 0.0 ; }
+	std::sort( samples.begin(), samples.end() ) ;
+	const size_t index = (size_t)std::ceil( rank / 100.0 * samples.size() ) ;
+	return samples[ std::min( std::max( index, (size_t)1 ), samples.size() ) - 1 ] ;
+}
+
+// one line of statistics for a stage
+void printStage( const char* const            name,
+                 const std::vector< double >& samples ) {
+	double sum = 0.0 ;
+	for( const double sample : samples ) { sum += sample ; }
+	printf( "%-10s %6zu  mean %8.2f  p50 %8.2f  p90 %8.2f  p99 %8.2f  max %8.2f\n", name, samples.size(),
+	        samples.empty() ? 0.0 : sum / samples.size(),
+	        percentile( samples, 50.0 ), percentile( samples, 90.0 ), percentile( samples, 99.0 ), percentile( samples, 100.0 ) ) ;
+}
+
+// order of file names: numerically if both start with a number - "PersonTracker" records "0.jpg", "1.jpg", ... -,
+// alphabetically otherwise
+bool fileNameLess( const std::string& a,
+                   const std::string& b ) {
+	const std::string nameA = a.substr( a.find_last_of( '/' ) + 1 ),
+	                  nameB = b.substr( b.find_last_of( '/' ) + 1 ) ;
+	char* endA ;
+	char* endB ;
+	const long numberA = std::strtol( nameA.c_str(), &endA, 10 ),
+	           numberB = std::strtol( nameB.c_str(), &endB, 10 ) ;
+	if( endA != nameA.c_str() && endB != nameB.c_str() && numberA != numberB ) { return numberA < numberB ; }
+	return a < b ;
+}
+
+// intersection over union of two boxes
+double overlap( const cv::Rect a,
+                const cv::Rect b ) {
+	const double intersection = ( a & b ).area(),
+	             both         = a.area() + b.area() - intersection ;
+	return both > 0.0 ? intersection / both : 0.0 ;
+}
+
+} // anonymous namespace
+
+// replay recorded front camera images through person detection, tracking and command generation, report per-stage
+// latencies, throughput, heap allocations per image and - given ground truth - tracking accuracy
+// user note: "source" is a folder of images, read in the order of their names, or a video file. Images must be the size
+//            "appFollowPersonFP" is fed with, i.e. downscaled by 0.5 like those recorded by "PersonTracker".
+// user note: Ground truth is a text file with lines "<image index> <x> <y> <width> <height>" - the format of
+//            "results_rect.txt" - of the followed person's box. A zero width or height means the person is not visible,
+//            images without a line are not evaluated.
+// user note: No ROS master, drone or display is needed. "focalLength" refers to the full resolution camera image.
+void followPersonBenchmark( const std::string  source,
+                            const std::string  groundTruthFile,
+                            const unsigned int seed,
+                            const double       focalLength ) {
+	
+	// never open windows, they would distort latencies
+	VisualSink::instance().setHeadless( true ) ;
+	
+	// images of a folder, otherwise a video
+	std::vector< std::string > files ;
+	cv::VideoCapture           video ;
+	DIR* directory = opendir( source.c_str() ) ;
+	if( directory != NULL ) {
+		for( struct dirent* entry = readdir( directory ) ; entry != NULL ; entry = readdir( directory ) ) {
+			const std::string name = entry->d_name ;
+			if( name != "." && name != ".." && name != ".svn" ) { files.push_back( source + "/" + name ) ; }
+		}
+		closedir( directory ) ;
+		std::sort( files.begin(), files.end(), fileNameLess ) ;
+	}
+	else {
+		HAWAII_ERROR_CONDITIONAL( !video.open( source ),
+		                          "Cannot open \"" + source + "\" as folder or video." ) ;
+	}
+	
+	// optional ground truth, per image index
+	std::map< int, cv::Rect > groundTruth ;
+	if( !groundTruthFile.empty() ) {
+		std::ifstream input( groundTruthFile.c_str() ) ;
+		HAWAII_ERROR_CONDITIONAL( !input.is_open(),
+		                          "Cannot open ground truth \"" + groundTruthFile + "\"." ) ;
+		std::string line ;
+		while( std::getline( input, line ) ) {
+			std::istringstream fields( line ) ;
+			int    index ;
+			double x, y, width, height ;
+			if( fields >> index >> x >> y >> width >> height ) {
+				groundTruth[ index ] = cv::Rect( cvRound( x ), cvRound( y ), cvRound( width ), cvRound( height ) ) ;
+			}
+		}
+	}
+	printf( "benchmark: source \"%s\", %s, seed %u, focal length %.1f\n", source.c_str(),
+	        groundTruth.empty() ? "no ground truth" : "with ground truth", seed, focalLength ) ;
+	
+	// per-stage latencies in milliseconds, allocations per image
+	// developer note: Detection is measured inside "PersonTracker", tracking is the rest of its processing. Both are
+	//                 only meaningful with a release build.
+	const int             warmup = 10 ; // images excluded from allocation statistics, as buffers settle
+	std::vector< double > timesDecode,
+	                      timesDetection,
+	                      timesTracking,
+	                      timesCommands,
+	                      timesTotal,
+	                      allocationsSteady ;
+	size_t                allocationsWarmup = 0 ;
+	
+	// tracking accuracy w.r.t. ground truth
+	std::vector< double > centerErrors,
+	                      overlaps ;
+	int framesVisible     = 0,
+	    framesAbsent      = 0,
+	    framesMissed      = 0,
+	    framesFalseAlarm  = 0,
+	    identitySwitches  = 0,
+	    followedIDPrev    = -1 ;
+	
+	// replay, the pipeline is set up once the image size is known
+	// developer note: Replayed images have no odometry, so the rotation is "NAN" and motion proposals register images
+	//                 instead. The translation only enters printed drift values.
+	std::unique_ptr< appFollowPersonFP > app ;
+	DroneCommands commands ;
+	const cv::Vec3d rotationUnknown( NAN, NAN, NAN ),
+	                translationUnknown( 0.0, 0.0, 0.0 ) ;
+	cv::Mat frame ;
+	int     frames     = 0 ;
+	int64   ticksStart = cv::getTickCount() ;
+	for( size_t file = 0 ; video.isOpened() || file < files.size() ; ++file ) {
+		int64 ticks = cv::getTickCount() ;
+		if( video.isOpened() ) {
+			if( !video.read( frame ) ) { break ; }
+		}
+		else {
+			frame = cv::imread( files[ file ], 1 ) ;
+			if( frame.empty() ) { continue ; }
+		}
+		timesDecode.push_back( millisecondsSince( ticks ) ) ;
+		if( !app ) {
+			// developer note: The principal point refers to the full resolution image as well, assumed at its center.
+			app.reset( new appFollowPersonFP( focalLength, frame.cols, frame.rows, "", seed ) ) ;
+		}
+		
+		// pipeline as called by "DroneAppDevelFP", allocations counted across all of its threads
+		const size_t allocationsBefore = heapAllocations() ;
+		ticks = cv::getTickCount() ;
+		app->processImageFront( frame, rotationUnknown, translationUnknown ) ;
+		const double timeProcess = millisecondsSince( ticks ) ;
+		ticks = cv::getTickCount() ;
+		app->getCommands( commands, rotationUnknown, translationUnknown ) ;
+		timesCommands.push_back( millisecondsSince( ticks ) ) ;
+		const size_t allocations = heapAllocations() - allocationsBefore ;
+		const PersonTracker& tracker = app->getPersonTracker() ;
+		if( tracker.stage != PersonTracker::stagePredict ) { timesDetection.push_back( tracker.timeDetection ) ; }
+		timesTracking.push_back( timeProcess - tracker.timeDetection ) ;
+		timesTotal.push_back( timeProcess + timesCommands.back() ) ;
+		if( frames < warmup ) { allocationsWarmup += allocations ; }
+		else                  { allocationsSteady.push_back( (double)allocations ) ; }
+		
+		// accuracy: the estimate with a box of the tracked height and the HOG window's aspect ratio
+		const std::map< int, cv::Rect >::const_iterator truth = groundTruth.find( frames ) ;
+		if( truth != groundTruth.end() ) {
+			const bool visible = truth->second.area() > 0 ;
+			const bool found   = tracker.foundDot && tracker.estimate.x >= 0 ;
+			if( visible ) {
+				++framesVisible ;
+				if( found ) {
+					const cv::Point2f center( truth->second.x + truth->second.width  * 0.5f,
+					                          truth->second.y + truth->second.height * 0.5f ) ;
+					const int height = cvRound( tracker.heightEstimate ),
+					          width  = height / 2 ;
+					const cv::Rect box( tracker.estimate.x - width / 2, tracker.estimate.y - height / 2, width, height ) ;
+					centerErrors.push_back( std::hypot( tracker.estimate.x - center.x, tracker.estimate.y - center.y ) ) ;
+					overlaps.push_back( overlap( box, truth->second ) ) ;
+				}
+				else {
+					++framesMissed ;
+				}
+			}
+			else {
+				++framesAbsent ;
+				if( found ) { ++framesFalseAlarm ; }
+			}
+		}
+		if( tracker.followedID >= 0 && followedIDPrev >= 0 && tracker.followedID != followedIDPrev ) { ++identitySwitches ; }
+		if( tracker.followedID >= 0 ) { followedIDPrev = tracker.followedID ; }
+		++frames ;
+	}
+	const double timeWall = millisecondsSince( ticksStart ) ;
+	HAWAII_ERROR_CONDITIONAL( frames == 0,
+	                          "No images found in \"" + source + "\"." ) ;
+	
+	// latencies and throughput
+	double timePipeline = 0.0 ;
+	for( const double time : timesTotal ) { timePipeline += time ; }
+	printf( "\nlatency [ms]  images\n" ) ;
+	printStage( "decode",    timesDecode    ) ;
+	printStage( "detection", timesDetection ) ;
+	printStage( "tracking",  timesTracking  ) ;
+	printStage( "commands",  timesCommands  ) ;
+	printStage( "total",     timesTotal     ) ;
+	printf( "throughput: %.1f images/s pipeline only, %.1f images/s including decoding\n",
+	        frames * 1000.0 / std::max( timePipeline, 1e-9 ), frames * 1000.0 / std::max( timeWall, 1e-9 ) ) ;
+	printf( "detection schedule: full %zu, motion %zu, ROI %zu, predict %zu\n",
+	        app->countDetectFull, app->countDetectMotion, app->countDetectROI, app->countPredict ) ;
+	
+	// allocations
+	if( heapAllocationsCounted() ) {
+		double sum = 0.0 ;
+		for( const double count : allocationsSteady ) { sum += count ; }
+		printf( "\nheap allocations per image: first %d images %.1f, afterwards mean %.1f p50 %.0f max %.0f\n",
+		        std::min( frames, warmup ), (double)allocationsWarmup / std::min( frames, warmup ),
+		        allocationsSteady.empty() ? 0.0 : sum / allocationsSteady.size(),
+		        percentile( allocationsSteady, 50.0 ), percentile( allocationsSteady, 100.0 ) ) ;
+	}
+	else {
+		printf( "\nheap allocations per image: not counted, build with \"make COUNT_HEAP_ALLOCATIONS=1\" on glibc\n" ) ;
+	}
+	
+	// accuracy
+	if( !groundTruth.empty() ) {
+		double errorSum   = 0.0,
+		       overlapSum = 0.0 ;
+		int    within20   = 0,
+		       overlapped = 0 ;
+		for( const double error : centerErrors ) { errorSum += error ; within20 += error <= 20.0 ; }
+		for( const double ratio : overlaps ) { overlapSum += ratio ; overlapped += ratio >= 0.5 ; }
+		const int tracked = (int)centerErrors.size() ;
+		printf( "\naccuracy: %d images with person, %d without\n", framesVisible, framesAbsent ) ;
+		printf( "tracked %d, missed %d, false alarms %d, identity switches %d\n",
+		        tracked, framesMissed, framesFalseAlarm, identitySwitches ) ;
+		printf( "center error [px]: mean %.1f p50 %.1f p90 %.1f, within 20 px %.1f %%\n",
+		        tracked ? errorSum / tracked : 0.0, percentile( centerErrors, 50.0 ), percentile( centerErrors, 90.0 ),
+		        framesVisible ? 100.0 * within20 / framesVisible : 0.0 ) ;
+		printf( "overlap: mean IoU %.3f, IoU >= 0.5 %.1f %%\n",
+		        tracked ? overlapSum / tracked : 0.0, framesVisible ? 100.0 * overlapped / framesVisible : 0.0 ) ;
+	}
+}
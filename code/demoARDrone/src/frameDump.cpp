@@ -0,0 +1,148 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// asynchronous writer for debug images and videos
+// ================================================
+
+#include "frameDump.h"
+#include "hawaii/common/error.h"
+#include <algorithm>
+
+// c'tor with output root and number of slots, starts the writer thread
+FrameDump::FrameDump( const std::string& rootArg,
+                      const int          capacityArg ) :
+	root( rootArg ),
+	jobs( std::max( capacityArg, 1 ) ),
+	first( 0 ),
+	count( 0 ),
+	stopping( false ),
+	writtenCount( 0 ),
+	droppedCount( 0 ),
+	failedCount( 0 ) {
+	HAWAII_ERROR_CONDITIONAL( capacityArg < 1,
+	                          "Number of slots must be positive." ) ;
+	if( this->enabled() ) {
+		this->writeThread = boost::thread( &FrameDump::writeThreadFunc, this ) ;
+	}
+}
+
+// d'tor, write all queued frames and join the writer thread
+FrameDump::~FrameDump() {
+	{
+		boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+		this->stopping = true ;
+	}
+	this->queued.notify_one() ;
+	if( this->writeThread.joinable() ) {
+		this->writeThread.join() ;
+	}
+}
+
+// queue a frame to be written as image file
+void FrameDump::pushImage( const std::string& name,
+                           const cv::Mat      image ) {
+	this->push( false, name, image, 0.0 ) ;
+}
+
+// queue a frame to be appended to a video file
+void FrameDump::pushVideo( const std::string& name,
+                           const cv::Mat      image,
+                           const double       fps ) {
+	this->push( true, name, image, fps ) ;
+}
+
+// copy a frame into the next free slot, dropping the oldest queued one if there is none
+void FrameDump::push( const bool         video,
+                      const std::string& name,
+                      const cv::Mat      image,
+                      const double       fps ) {
+	if( !this->enabled() ) { return ; }
+	{
+		boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+		if( this->count == (int)this->jobs.size() ) {
+			this->first = ( this->first + 1 ) % (int)this->jobs.size() ;
+			--this->count ;
+			++this->droppedCount ;
+		}
+		Job& job = this->jobs[ ( this->first + this->count ) % (int)this->jobs.size() ] ;
+		job.video = video ;
+		job.name  = name ;
+		job.fps   = fps ;
+		image.copyTo( job.image ) ; // developer note: Re-uses the slot's buffer once the image size has settled.
+		++this->count ;
+	}
+	this->queued.notify_one() ;
+}
+
+// counters
+size_t FrameDump::written() const {
+	boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+	return this->writtenCount ;
+}
+size_t FrameDump::dropped() const {
+	boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+	return this->droppedCount ;
+}
+size_t FrameDump::failed() const {
+	boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+	return this->failedCount ;
+}
+
+// take the oldest queued frame out of its slot and encode it, until stopped and all frames are written
+// developer note: The slot's image is swapped with the thread's own one, so both buffers keep circulating instead of
+//                 being re-allocated, and the lock is not held while encoding.
+void FrameDump::writeThreadFunc() {
+	Job job ;
+	while( true ) {
+		{
+			boost::unique_lock< boost::mutex > lock( this->mutex ) ;
+			while( this->count == 0 && !this->stopping ) {
+				this->queued.wait( lock ) ;
+			}
+			if( this->count == 0 ) { break ; }
+			Job& slot = this->jobs[ this->first ] ;
+			job.video = slot.video ;
+			job.name.swap( slot.name ) ;
+			job.fps   = slot.fps ;
+			std::swap( job.image, slot.image ) ;
+			this->first = ( this->first + 1 ) % (int)this->jobs.size() ;
+			--this->count ;
+		}
+		
+		// encode and write
+		const std::string path = this->root + "/" + job.name ;
+		bool success = false ;
+		try {
+			if( job.video ) {
+				if( !this->videoOut.isOpened() || job.name != this->videoName || job.image.size() != this->videoSize ) {
+					this->videoOut.open( path, CV_FOURCC( 'D', 'I', 'V', 'X' ), job.fps, job.image.size() ) ;
+					this->videoName = job.name ;
+					this->videoSize = job.image.size() ;
+				}
+				if( this->videoOut.isOpened() ) {
+					this->videoOut << job.image ;
+					success = true ;
+				}
+			}
+			else {
+				success = cv::imwrite( path, job.image ) ;
+			}
+		} catch( const cv::Exception& ) {}
+		
+		boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+		++( success ? this->writtenCount : this->failedCount ) ;
+	}
+}
@@ -0,0 +1,97 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// asynchronous writer for debug images and videos
+// ================================================
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <string>
+#include <vector>
+
+// bounded queue of frames encoded by a dedicated thread: "pushImage()" and "pushVideo()" only copy the frame into a
+//                                                       pre-allocated slot, JPEG and video encoding as well as disk
+//                                                       access happen on the writer thread. When the disk falls behind
+//                                                       and all slots are taken, the oldest queued frame is dropped.
+// user note: File names are relative to the output root. An empty root disables dumping altogether, and subfolders are
+//            expected to exist.
+class FrameDump {
+	
+	// c'tor with output root and number of slots, starts the writer thread, d'tor writes all queued frames and joins it
+	public:
+	FrameDump( const std::string& rootArg,
+	           const int          capacityArg = 8 ) ;
+	~FrameDump() ;
+	protected:
+	std::string root ;
+	
+	// non-copyable because of the owned thread
+	private:
+	FrameDump(             const FrameDump& ) ;
+	FrameDump& operator =( const FrameDump& ) ;
+	
+	// queue a frame to be written as image file, or appended to a video file opened with the size of its first frame
+	// user note: Both return immediately, the frame is copied.
+	public:
+	bool enabled() const { return !this->root.empty() ; }
+	void pushImage( const std::string& name,
+	                const cv::Mat      image ) ;
+	void pushVideo( const std::string& name,
+	                const cv::Mat      image,
+	                const double       fps ) ;
+	
+	// counters: frames written, dropped because the queue was full, failed to encode or write
+	public:
+	size_t written() const ;
+	size_t dropped() const ;
+	size_t failed()  const ;
+	
+	// queue: ring of slots re-using their image buffers, writer thread and its synchronization
+	protected:
+	struct Job {
+		bool        video ;
+		std::string name ;
+		cv::Mat     image ;
+		double      fps ;
+	} ;
+	void push( const bool         video,
+	           const std::string& name,
+	           const cv::Mat      image,
+	           const double       fps ) ;
+	void writeThreadFunc() ;
+	std::vector< Job >        jobs ;
+	int                       first,
+	                          count ;
+	bool                      stopping ;
+	size_t                    writtenCount,
+	                          droppedCount,
+	                          failedCount ;
+	mutable boost::mutex      mutex ;
+	boost::condition_variable queued ;
+	boost::thread             writeThread ;
+	
+	// video file, only accessed by the writer thread, re-opened (i.e. overwritten) when its name or the image size changes
+	protected:
+	cv::VideoWriter videoOut ;
+	std::string     videoName ;
+	cv::Size        videoSize ;
+
+} ; // class "FrameDump"
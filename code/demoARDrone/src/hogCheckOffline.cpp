@@ -0,0 +1,100 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// off-line accuracy check of the fixed point people SVM against float
+// ====================================================================
+
+#include "hogFeatureCache.h"
+#include "hawaii/common/error.h"
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/objdetect/objdetect.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <dirent.h>
+
+// run the HOG feature cache on all images of "folder" (e.g. frames recorded by "PersonTracker"), compare fixed point
+// and float window scores as well as detection times
+void hogCheckOffline( std::string folder ) {
+	
+	// recorded frames in alphabetical order
+	std::vector< std::string > files ;
+	DIR* directory = opendir( folder.c_str() ) ;
+	HAWAII_ERROR_CONDITIONAL( directory == NULL,
+	                          "Cannot open directory \"" + folder + "\"." ) ;
+	for( struct dirent* entry = readdir( directory ) ; entry != NULL ; entry = readdir( directory ) ) {
+		const std::string name = entry->d_name ;
+		if( name != "." && name != ".." && name != ".svn" ) { files.push_back( folder + "/" + name ) ; }
+	}
+	closedir( directory ) ;
+	std::sort( files.begin(), files.end() ) ;
+	
+	// same detector parameters as "PersonTracker"
+	// developer note: Every frame is evaluated from scratch, so that the comparison does not depend on their order.
+	HOGFeatureCache cache( cv::HOGDescriptor::getDefaultPeopleDetector(), true ) ;
+	cache.reuseThreshold = -1.0 ;
+	const double   hitThreshold = 0.0 ;
+	const cv::Size padding( 32, 32 ) ;
+	const double   scale = 1.05 ;
+	printf( "fixed point SVM kernel: %s\n", cache.svmFixedPoint().kernelName() ) ;
+	
+	// compare per frame and in total
+	HOGFeatureCache::FixedPointAccuracy total = { 0, 0.0, 0.0, 0, 0, 0 } ;
+	double timeFloat      = 0.0,
+	       timeFixedPoint = 0.0 ;
+	int    frames         = 0 ;
+	std::vector< cv::Rect > found ;
+	std::vector< double   > foundWeights ;
+	for( const auto& file : files ) {
+		const cv::Mat frame = cv::imread( file, 1 ) ;
+		if( frame.empty() ) { continue ; }
+		const cv::Rect roi( cv::Point( 0, 0 ), frame.size() ) ;
+		cache.beginFrame() ;
+		const HOGFeatureCache::FixedPointAccuracy accuracy = cache.checkFixedPoint( frame, roi, hitThreshold, padding, scale ) ;
+		
+		// detection times of both paths
+		double timeStart ;
+		cache.useFixedPoint = false ;
+		timeStart = (double)cv::getTickCount() ;
+		cache.detectMultiScale( frame, roi, found, foundWeights, hitThreshold, padding, scale, 2 ) ;
+		timeFloat += ( (double)cv::getTickCount() - timeStart ) * 1000.0 / cv::getTickFrequency() ;
+		cache.useFixedPoint = true ;
+		timeStart = (double)cv::getTickCount() ;
+		cache.detectMultiScale( frame, roi, found, foundWeights, hitThreshold, padding, scale, 2 ) ;
+		timeFixedPoint += ( (double)cv::getTickCount() - timeStart ) * 1000.0 / cv::getTickFrequency() ;
+		
+		printf( "%s: windows %zu, score error max %.5f mean %.5f, hits float %zu fixed point %zu differing %zu\n",
+		        file.c_str(), accuracy.windows, accuracy.errorMax, accuracy.errorSum / std::max( accuracy.windows, (size_t)1 ),
+		        accuracy.hitsFloat, accuracy.hitsFixedPoint, accuracy.hitsDiffer ) ;
+		total.windows        += accuracy.windows ;
+		total.errorMax        = std::max( total.errorMax, accuracy.errorMax ) ;
+		total.errorSum       += accuracy.errorSum ;
+		total.hitsFloat      += accuracy.hitsFloat ;
+		total.hitsFixedPoint += accuracy.hitsFixedPoint ;
+		total.hitsDiffer     += accuracy.hitsDiffer ;
+		++frames ;
+	}
+	HAWAII_ERROR_CONDITIONAL( frames == 0,
+	                          "No images found in \"" + folder + "\"." ) ;
+	
+	// summary
+	printf( "total: %d frames, %zu windows, score error max %.5f mean %.5f, hits float %zu fixed point %zu differing %zu\n",
+	        frames, total.windows, total.errorMax, total.errorSum / std::max( total.windows, (size_t)1 ),
+	        total.hitsFloat, total.hitsFixedPoint, total.hitsDiffer ) ;
+	printf( "mean detection time: float %.2f ms, fixed point %.2f ms\n",
+	        timeFloat / frames, timeFixedPoint / frames ) ;
+}
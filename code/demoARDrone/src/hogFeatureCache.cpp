@@ -0,0 +1,436 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// HOG feature pyramid via integral histograms, cached across consecutive frames
+// ==============================================================================
+
+#include "hogFeatureCache.h"
+#include "hawaii/common/error.h"
+#include <opencv2/objdetect/objdetect.hpp>
+#include <algorithm>
+#include <cmath>
+
+// helpers only used here
+namespace {
+
+// unsigned orientation of a gradient, split linearly between the two nearest bin centers, same as "cv::HOGDescriptor"
+inline void binGradient( const float      dx,
+                         const float      dy,
+                               cv::Vec2b& binsPixel,
+                               cv::Vec2f& weightsPixel ) {
+	const int   bins      = HOGFeatureCache::bins ;
+	const float magnitude = std::sqrt( dx * dx + dy * dy ) ;
+	float angle = std::atan2( dy, dx ) ;
+	if( angle < 0.0f ) { angle += (float)( 2.0 * CV_PI ) ; }
+	const float binExact = angle * (float)( bins / CV_PI ) - 0.5f ;
+	int         bin0     = (int)std::floor( binExact ) ;
+	const float share1   = binExact - bin0 ;
+	if(      bin0 <  0    ) { bin0 += bins ; }
+	else if( bin0 >= bins ) { bin0 -= bins ; }
+	const int bin1 = ( bin0 + 1 < bins ) ? bin0 + 1 : 0 ;
+	binsPixel    = cv::Vec2b( (uchar)bin0, (uchar)bin1 ) ;
+	weightsPixel = cv::Vec2f( magnitude * ( 1.0f - share1 ), magnitude * share1 ) ;
+}
+
+// L2-Hys block normalization, same as "cv::HOGDescriptor"
+inline void normalizeBlock( float* const block ) {
+	const int   size      = HOGFeatureCache::blockSizeHist ;
+	const float threshold = 0.2f ;
+	float sum = 0.0f ;
+	for( int index = 0 ; index < size ; ++index ) { sum += block[ index ] * block[ index ] ; }
+	float scale = 1.0f / ( std::sqrt( sum ) + size * 0.1f ) ;
+	sum = 0.0f ;
+	for( int index = 0 ; index < size ; ++index ) {
+		block[ index ] = std::min( block[ index ] * scale, threshold ) ;
+		sum += block[ index ] * block[ index ] ;
+	}
+	scale = 1.0f / ( std::sqrt( sum ) + 1e-3f ) ;
+	for( int index = 0 ; index < size ; ++index ) { block[ index ] *= scale ; }
+}
+
+// SVM weights without bias, checked against the fixed geometry
+std::vector< float > svmWeightsOf( const std::vector< float >& svmDetector ) {
+	const size_t descriptorSize = (size_t)( HOGFeatureCache::windowCellsX - 1 ) * ( HOGFeatureCache::windowCellsY - 1 )
+	                            * HOGFeatureCache::blockSizeHist ;
+	HAWAII_ERROR_CONDITIONAL( svmDetector.size() != descriptorSize
+	                       && svmDetector.size() != descriptorSize + 1,
+	                          "SVM does not match the HOG geometry of the default people detector." ) ;
+	return std::vector< float >( svmDetector.begin(), svmDetector.begin() + descriptorSize ) ;
+}
+
+// SVM bias, zero if not given
+float svmBiasOf( const std::vector< float >& svmDetector ) {
+	const size_t descriptorSize = (size_t)( HOGFeatureCache::windowCellsX - 1 ) * ( HOGFeatureCache::windowCellsY - 1 )
+	                            * HOGFeatureCache::blockSizeHist ;
+	return svmDetector.size() > descriptorSize ? svmDetector.back() : 0.0f ;
+}
+
+} // anonymous namespace
+
+// c'tor with linear SVM, gamma correction and number of cores to use
+HOGFeatureCache::HOGFeatureCache( const std::vector< float >& svmDetectorArg,
+                                  const bool                  gammaCorrectionArg,
+                                  const int                   coresArg           ) :
+	levelScaleMin( 1.0 ),
+	levelScaleMax( HUGE_VAL ),
+	reuseThreshold( 2.0 ),
+	cellsComputed( 0 ),
+	cellsReused( 0 ),
+	useFixedPoint( true ),
+	svmDetector( svmWeightsOf( svmDetectorArg ) ),
+	svmBias( svmBiasOf( svmDetectorArg ) ),
+	svmFixed( this->svmDetector, blockSizeHist, windowCellsX - blockCells + 1, windowCellsY - blockCells + 1 ),
+	gammaCorrection( gammaCorrectionArg ),
+	cores( std::max( coresArg, 1 ) ),
+	frameIndex( 1 ),
+	integralStride( 0 ) {
+	for( int value = 0 ; value < 256 ; ++value ) {
+		this->gammaLUT[ value ] = this->gammaCorrection ? std::sqrt( (float)value ) : (float)value ;
+	}
+}
+
+// start a new frame: advance the index cells are stamped with, reset the counters
+void HOGFeatureCache::beginFrame() {
+	if( ++this->frameIndex == 0 ) { this->frameIndex = 1 ; } // developer note: 0 marks cells never computed.
+	this->cellsComputed = 0 ;
+	this->cellsReused   = 0 ;
+}
+
+// compute gradients of all cells within "region" unless they are unchanged since they were last computed
+void HOGFeatureCache::updateGradients( const cv::Mat& frame,
+                                       const cv::Rect region ) {
+	
+	// (re-)allocate and invalidate everything if the image size changes
+	const int cellsX = ( frame.cols + cellSize - 1 ) / cellSize,
+	          cellsY = ( frame.rows + cellSize - 1 ) / cellSize ;
+	if( frame.size() != this->sizeFrame || frame.type() != this->reference.type() ) {
+		this->sizeFrame = frame.size() ;
+		this->gradBins.create(    this->sizeFrame, CV_8UC2  ) ;
+		this->gradWeights.create( this->sizeFrame, CV_32FC2 ) ;
+		this->reference.create(   this->sizeFrame, frame.type() ) ;
+		this->cellFrame.assign( cellsX * cellsY, 0 ) ;
+		this->frameIndex = 1 ;
+	}
+	
+	// cells covered by the region
+	const int cellX0 =   region.x                                    / cellSize,
+	          cellY0 =   region.y                                    / cellSize,
+	          cellX1 = ( region.x + region.width  + cellSize - 1 ) / cellSize,
+	          cellY1 = ( region.y + region.height + cellSize - 1 ) / cellSize ;
+	const cv::Rect     frameRect( cv::Point( 0, 0 ), frame.size() ) ;
+	const int          channels       = frame.channels() ;
+	const double       reuseThreshold = this->reuseThreshold ;
+	const unsigned int frameIndex     = this->frameIndex ;
+	const int          cores          = this->cores ;
+	const int          regionCellsX   = cellX1 - cellX0 ;
+	this->cellChanged.assign( regionCellsX * ( cellY1 - cellY0 ), 0 ) ;
+	size_t computed = 0,
+	       reused   = 0 ;
+	
+	// re-use if the pixels this cell was computed from are (almost) unchanged, including the one pixel wide border
+	// its central differences read from neighboring cells
+	// developer note: The reference is only written after all cells are checked, as the borders of neighboring cells
+	//                 overlap.
+	#pragma omp parallel for                \
+		if( cores > 1 ) num_threads( cores ) \
+		schedule( dynamic )                  \
+		reduction( + : computed, reused )
+	for( int cellY = cellY0 ; cellY < cellY1 ; ++cellY ) {
+	for( int cellX = cellX0 ; cellX < cellX1 ; ++cellX ) {
+		const cv::Rect cellGrown = cv::Rect( cellX * cellSize - 1, cellY * cellSize - 1, cellSize + 2, cellSize + 2 ) & frameRect ;
+		unsigned int&  stamp     = this->cellFrame[ cellY * cellsX + cellX ] ;
+		if( stamp != 0 && reuseThreshold >= 0.0
+		 && cv::norm( frame( cellGrown ), this->reference( cellGrown ), cv::NORM_L1 ) <= reuseThreshold * cellGrown.area() * channels ) {
+			stamp = frameIndex ;
+			++reused ;
+			continue ;
+		}
+		
+		// central differences with reflected border, keep the channel of largest magnitude
+		const cv::Rect cell = cv::Rect( cellX * cellSize, cellY * cellSize, cellSize, cellSize ) & frameRect ;
+		for( int y = cell.y ; y < cell.y + cell.height ; ++y ) {
+			const uchar* const rowCurr  = frame.ptr< uchar >( y ) ;
+			const uchar* const rowAbove = frame.ptr< uchar >( y > 0              ? y - 1 : std::min( 1, frame.rows - 1 ) ) ;
+			const uchar* const rowBelow = frame.ptr< uchar >( y < frame.rows - 1 ? y + 1 : std::max( frame.rows - 2, 0 ) ) ;
+			for( int x = cell.x ; x < cell.x + cell.width ; ++x ) {
+				const int xLeft  = x > 0              ? x - 1 : std::min( 1, frame.cols - 1 ),
+				          xRight = x < frame.cols - 1 ? x + 1 : std::max( frame.cols - 2, 0 ) ;
+				float dxMax = 0.0f, dyMax = 0.0f, magnitudeMax = -1.0f ;
+				for( int channel = 0 ; channel < channels ; ++channel ) {
+					const float dx = this->gammaLUT[ rowCurr[  xRight * channels + channel ] ]
+					               - this->gammaLUT[ rowCurr[  xLeft  * channels + channel ] ],
+					            dy = this->gammaLUT[ rowBelow[ x      * channels + channel ] ]
+					               - this->gammaLUT[ rowAbove[ x      * channels + channel ] ] ;
+					const float magnitude = dx * dx + dy * dy ;
+					if( magnitude > magnitudeMax ) {
+						magnitudeMax = magnitude ;
+						dxMax = dx ;
+						dyMax = dy ;
+					}
+				}
+				binGradient( dxMax, dyMax, this->gradBins.at< cv::Vec2b >( y, x ), this->gradWeights.at< cv::Vec2f >( y, x ) ) ;
+			}
+		}
+		this->cellChanged[ ( cellY - cellY0 ) * regionCellsX + ( cellX - cellX0 ) ] = 1 ;
+		stamp = frameIndex ;
+		++computed ;
+	} }
+	
+	// remember the pixels recomputed cells read, border included
+	for( int cellY = cellY0 ; cellY < cellY1 ; ++cellY ) {
+	for( int cellX = cellX0 ; cellX < cellX1 ; ++cellX ) {
+		if( !this->cellChanged[ ( cellY - cellY0 ) * regionCellsX + ( cellX - cellX0 ) ] ) { continue ; }
+		const cv::Rect cellGrown = cv::Rect( cellX * cellSize - 1, cellY * cellSize - 1, cellSize + 2, cellSize + 2 ) & frameRect ;
+		frame( cellGrown ).copyTo( this->reference( cellGrown ) ) ;
+	} }
+	this->cellsComputed += computed ;
+	this->cellsReused   += reused   ;
+}
+
+// per-bin integral histogram of gradient magnitudes within "region"
+void HOGFeatureCache::updateIntegral( const cv::Rect region ) {
+	this->integralStride = ( region.width + 1 ) * bins ;
+	this->integral.resize( ( region.height + 1 ) * this->integralStride ) ;
+	std::fill( this->integral.begin(), this->integral.begin() + this->integralStride, 0.0 ) ;
+	for( int y = 0 ; y < region.height ; ++y ) {
+		const cv::Vec2b* const binsRow    = this->gradBins.ptr<    cv::Vec2b >( region.y + y ) + region.x ;
+		const cv::Vec2f* const weightsRow = this->gradWeights.ptr< cv::Vec2f >( region.y + y ) + region.x ;
+		const double*    const above      = &this->integral[ ( y     ) * this->integralStride ] ;
+		      double*    const curr       = &this->integral[ ( y + 1 ) * this->integralStride ] ;
+		double sumRow[ bins ] = { 0.0 } ;
+		std::fill( curr, curr + bins, 0.0 ) ;
+		for( int x = 0 ; x < region.width ; ++x ) {
+			sumRow[ binsRow[ x ][ 0 ] ] += weightsRow[ x ][ 0 ] ;
+			sumRow[ binsRow[ x ][ 1 ] ] += weightsRow[ x ][ 1 ] ;
+			for( int bin = 0 ; bin < bins ; ++bin ) {
+				curr[ ( x + 1 ) * bins + bin ] = above[ ( x + 1 ) * bins + bin ] + sumRow[ bin ] ;
+			}
+		}
+	}
+}
+
+// cell histograms, normalized blocks and window scores of a single pyramid level
+void HOGFeatureCache::evaluateLevel( const int      level,
+                                     const cv::Rect region,
+                                     const int      paddingCells,
+                                     const double   hitThreshold ) {
+	
+	// level geometry in cells, including empty padding cells
+	const double levelScale = this->levelScales[ level ] ;
+	const double cellLevel  = cellSize * levelScale ;
+	const int    cellsX     = (int)( region.width  / cellLevel ),
+	             cellsY     = (int)( region.height / cellLevel ),
+	             gridX      = cellsX + 2 * paddingCells,
+	             gridY      = cellsY + 2 * paddingCells ;
+	
+	// cell histograms from the integral histogram
+	// developer note: Dividing by the level scale keeps magnitudes comparable to a HOG computed on a resized image,
+	//                 which matters because block normalization is not entirely scale-invariant.
+	std::vector< float >& cells = this->levelCells[ level ] ;
+	cells.assign( gridX * gridY * bins, 0.0f ) ;
+	const float normalization = (float)( 1.0 / levelScale ) ;
+	for( int cellY = 0 ; cellY < cellsY ; ++cellY ) {
+		const int y0 = (int)std::floor( cellY       * cellLevel + 0.5 ),
+		          y1 = std::min( (int)std::floor( ( cellY + 1 ) * cellLevel + 0.5 ), region.height ) ;
+		for( int cellX = 0 ; cellX < cellsX ; ++cellX ) {
+			const int x0 = (int)std::floor( cellX       * cellLevel + 0.5 ),
+			          x1 = std::min( (int)std::floor( ( cellX + 1 ) * cellLevel + 0.5 ), region.width ) ;
+			const double* const topLeft     = &this->integral[ y0 * this->integralStride + x0 * bins ] ;
+			const double* const topRight    = &this->integral[ y0 * this->integralStride + x1 * bins ] ;
+			const double* const bottomLeft  = &this->integral[ y1 * this->integralStride + x0 * bins ] ;
+			const double* const bottomRight = &this->integral[ y1 * this->integralStride + x1 * bins ] ;
+			float* const hist = &cells[ ( ( cellY + paddingCells ) * gridX + cellX + paddingCells ) * bins ] ;
+			for( int bin = 0 ; bin < bins ; ++bin ) {
+				hist[ bin ] = (float)( bottomRight[ bin ] - bottomLeft[ bin ] - topRight[ bin ] + topLeft[ bin ] ) * normalization ;
+			}
+		}
+	}
+	
+	// normalized blocks, cells ordered column-major within each block like "cv::HOGDescriptor"
+	const int blocksX = gridX - blockCells + 1,
+	          blocksY = gridY - blockCells + 1 ;
+	std::vector< float >& blocks = this->levelBlocks[ level ] ;
+	blocks.resize( blocksX * blocksY * blockSizeHist ) ;
+	for( int blockY = 0 ; blockY < blocksY ; ++blockY ) {
+	for( int blockX = 0 ; blockX < blocksX ; ++blockX ) {
+		float* const block = &blocks[ ( blockY * blocksX + blockX ) * blockSizeHist ] ;
+		for( int cellX = 0 ; cellX < blockCells ; ++cellX ) {
+		for( int cellY = 0 ; cellY < blockCells ; ++cellY ) {
+			const float* const hist = &cells[ ( ( blockY + cellY ) * gridX + blockX + cellX ) * bins ] ;
+			std::copy( hist, hist + bins, block + ( cellX * blockCells + cellY ) * bins ) ;
+		} }
+		normalizeBlock( block ) ;
+	} }
+	this->levelSizeBlocks[ level ] = cv::Size( blocksX, blocksY ) ;
+	if( this->useFixedPoint ) {
+		this->levelBlocksFixed[ level ].resize( blocksX * blocksY * this->svmFixed.blockStride() ) ;
+		this->svmFixed.quantize( &blocks[ 0 ], blocksX * blocksY, &this->levelBlocksFixed[ level ][ 0 ] ) ;
+	}
+	
+	// window scores
+	const cv::Size sizeScaled( cvRound( windowCellsX * cellSize * levelScale ),
+	                           cvRound( windowCellsY * cellSize * levelScale ) ) ;
+	this->levelHits[    level ].clear() ;
+	this->levelWeights[ level ].clear() ;
+	for( int windowY = 0 ; windowY + windowCellsY <= gridY ; ++windowY ) {
+	for( int windowX = 0 ; windowX + windowCellsX <= gridX ; ++windowX ) {
+		const double score = this->scoreWindow( level, windowX, windowY, this->useFixedPoint ) ;
+		if( score >= hitThreshold ) {
+			this->levelHits[ level ].push_back( cv::Rect( cv::Point( cvRound( ( windowX - paddingCells ) * cellLevel ),
+			                                                         cvRound( ( windowY - paddingCells ) * cellLevel ) ),
+			                                              sizeScaled ) ) ;
+			this->levelWeights[ level ].push_back( score ) ;
+		}
+	} }
+}
+
+// SVM score of a single window of a level evaluated before, blocks ordered column-major like "cv::HOGDescriptor"
+double HOGFeatureCache::scoreWindow( const int  level,
+                                     const int  windowX,
+                                     const int  windowY,
+                                     const bool fixedPoint ) const {
+	const int blocksX = this->levelSizeBlocks[ level ].width ;
+	if( fixedPoint ) {
+		const std::ptrdiff_t strideX = this->svmFixed.blockStride(),
+		                     strideY = strideX * blocksX ;
+		return this->svmBias + this->svmFixed.score( &this->levelBlocksFixed[ level ][ ( windowY * blocksX + windowX ) * strideX ],
+		                                             strideX, strideY ) ;
+	}
+	const int windowBlocksX = windowCellsX - blockCells + 1,
+	          windowBlocksY = windowCellsY - blockCells + 1 ;
+	const std::vector< float >& blocks = this->levelBlocks[ level ] ;
+	double score = this->svmBias ;
+	const float* weights = &this->svmDetector[ 0 ] ;
+	for( int blockX = 0 ; blockX < windowBlocksX ; ++blockX ) {
+	for( int blockY = 0 ; blockY < windowBlocksY ; ++blockY, weights += blockSizeHist ) {
+		const float* const block = &blocks[ ( ( windowY + blockY ) * blocksX + windowX + blockX ) * blockSizeHist ] ;
+		float dot = 0.0f ;
+		for( int index = 0 ; index < blockSizeHist ; ++index ) { dot += block[ index ] * weights[ index ] ; }
+		score += dot ;
+	} }
+	return score ;
+}
+
+// detect within "roi" of "frame" at multiple scales
+void HOGFeatureCache::detectMultiScale( const cv::Mat                frame,
+                                        const cv::Rect               roi,
+                                              std::vector< cv::Rect >& found,
+                                              std::vector< double   >& foundWeights,
+                                        const double                 hitThreshold,
+                                        const cv::Size               padding,
+                                        const double                 scale,
+                                        const int                    groupThreshold ) {
+	
+	// check input
+	HAWAII_ERROR_CONDITIONAL( frame.empty(),
+	                          "Image must not be empty." ) ;
+	HAWAII_ERROR_CONDITIONAL( frame.type() != CV_8UC1 && frame.type() != CV_8UC3,
+	                          "Image type must be \"CV_8UC1\" or \"CV_8UC3\"." ) ;
+	HAWAII_ERROR_CONDITIONAL( ( roi & cv::Rect( cv::Point( 0, 0 ), frame.size() ) ) != roi || roi.area() == 0,
+	                          "Region of interest must be non-empty and within the image." ) ;
+	HAWAII_ERROR_CONDITIONAL( scale <= 1.0,
+	                          "Scale step must be greater than 1." ) ;
+	found.clear() ;
+	foundWeights.clear() ;
+	
+	// expand the region of interest to full cells, so that cells are aligned across frames
+	const int x0 =   roi.x                                       / cellSize * cellSize,
+	          y0 =   roi.y                                       / cellSize * cellSize,
+	          x1 = std::min( ( roi.x + roi.width  + cellSize - 1 ) / cellSize * cellSize, frame.cols ),
+	          y1 = std::min( ( roi.y + roi.height + cellSize - 1 ) / cellSize * cellSize, frame.rows ) ;
+	const cv::Rect region( x0, y0, x1 - x0, y1 - y0 ) ;
+	
+	// shared stages: gradients at the original resolution, integral histogram
+	this->updateGradients( frame, region ) ;
+	this->updateIntegral( region ) ;
+	
+	// pyramid levels as long as a window still fits, within the range of scales
+	this->levelScales.clear() ;
+	for( double levelScale = 1.0 ;
+	     (int)( region.width  / ( cellSize * levelScale ) ) >= windowCellsX
+	  && (int)( region.height / ( cellSize * levelScale ) ) >= windowCellsY
+	  && this->levelScales.size() < 64
+	  && levelScale <= this->levelScaleMax ;
+	     levelScale *= scale ) {
+		if( levelScale >= this->levelScaleMin ) { this->levelScales.push_back( levelScale ) ; }
+	}
+	const int levelsCount = (int)this->levelScales.size() ;
+	this->levelCells.resize(       levelsCount ) ;
+	this->levelBlocks.resize(      levelsCount ) ;
+	this->levelBlocksFixed.resize( levelsCount ) ;
+	this->levelSizeBlocks.resize(  levelsCount ) ;
+	this->levelHits.resize(        levelsCount ) ;
+	this->levelWeights.resize(     levelsCount ) ;
+	
+	// evaluate levels in parallel
+	const int paddingCells = std::min( padding.width, padding.height ) / cellSize ;
+	const int cores        = this->cores ;
+	#pragma omp parallel for                \
+		if( cores > 1 ) num_threads( cores ) \
+		schedule( dynamic )
+	for( int level = 0 ; level < levelsCount ; ++level ) {
+		this->evaluateLevel( level, region, paddingCells, hitThreshold ) ;
+	}
+	
+	// merge hits of all levels relative to "roi", group them once
+	const cv::Point shift = region.tl() - roi.tl() ;
+	for( int level = 0 ; level < levelsCount ; ++level ) {
+		for( size_t hit = 0 ; hit < this->levelHits[ level ].size() ; ++hit ) {
+			found.push_back( this->levelHits[ level ][ hit ] + shift ) ;
+			foundWeights.push_back( this->levelWeights[ level ][ hit ] ) ;
+		}
+	}
+	this->rejectLevels.assign( found.size(), 0 ) ;
+	cv::groupRectangles( found, this->rejectLevels, foundWeights, groupThreshold, 0.2 ) ;
+}
+
+// compare fixed point and float scores of all windows
+HOGFeatureCache::FixedPointAccuracy HOGFeatureCache::checkFixedPoint( const cv::Mat  frame,
+                                                                      const cv::Rect roi,
+                                                                      const double   hitThreshold,
+                                                                      const cv::Size padding,
+                                                                      const double   scale ) {
+	
+	// evaluate all levels once with quantized blocks, keeping the float ones as well
+	const bool useFixedPoint = this->useFixedPoint ;
+	this->useFixedPoint = true ;
+	std::vector< cv::Rect > found ;
+	std::vector< double   > foundWeights ;
+	this->detectMultiScale( frame, roi, found, foundWeights, hitThreshold, padding, scale, 0 ) ;
+	this->useFixedPoint = useFixedPoint ;
+	
+	// score every window both ways
+	FixedPointAccuracy accuracy = { 0, 0.0, 0.0, 0, 0, 0 } ;
+	for( int level = 0 ; level < (int)this->levelScales.size() ; ++level ) {
+		const int gridX = this->levelSizeBlocks[ level ].width  + blockCells - 1,
+		          gridY = this->levelSizeBlocks[ level ].height + blockCells - 1 ;
+		for( int windowY = 0 ; windowY + windowCellsY <= gridY ; ++windowY ) {
+		for( int windowX = 0 ; windowX + windowCellsX <= gridX ; ++windowX ) {
+			const double scoreFloat      = this->scoreWindow( level, windowX, windowY, false ),
+			             scoreFixedPoint = this->scoreWindow( level, windowX, windowY, true  ),
+			             error           = std::abs( scoreFixedPoint - scoreFloat ) ;
+			const bool   hitFloat        = scoreFloat      >= hitThreshold,
+			             hitFixedPoint   = scoreFixedPoint >= hitThreshold ;
+			++accuracy.windows ;
+			accuracy.errorMax        = std::max( accuracy.errorMax, error ) ;
+			accuracy.errorSum       += error ;
+			accuracy.hitsFloat      += hitFloat      ? 1 : 0 ;
+			accuracy.hitsFixedPoint += hitFixedPoint ? 1 : 0 ;
+			accuracy.hitsDiffer     += hitFloat != hitFixedPoint ? 1 : 0 ;
+		} }
+	}
+	return accuracy ;
+}
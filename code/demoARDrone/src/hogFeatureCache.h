@@ -0,0 +1,159 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// HOG feature pyramid via integral histograms, cached across consecutive frames
+// ==============================================================================
+
+#pragma once
+
+#include "fixedPointSVM.h"
+#include "hawaii/common/hardware.h"
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+// HOG people detection sharing work between pyramid levels and frames: Gradients are computed once per frame at the
+//                                                                     original resolution, and only for cells of the
+//                                                                     search region whose pixels have changed. Cell
+//                                                                     histograms of every pyramid level are summed from
+//                                                                     per-bin integral histograms in O(bins), blocks are
+//                                                                     normalized once per level, and each window's SVM
+//                                                                     score is a sum over these precomputed blocks.
+// user note #1: The geometry is fixed to that of "cv::HOGDescriptor::getDefaultPeopleDetector()": 64x128 windows,
+//               16x16 blocks, 8x8 cells and block stride, 9 unsigned orientation bins and a window stride of one cell.
+// user note #2: This approximates OpenCV's HOG: Cells sum gradients without spatial interpolation and Gaussian block
+//               weighting, and padding cells are empty rather than computed on a reflected border. Scores are
+//               therefore close to, but not identical with, those of "cv::HOGDescriptor".
+class HOGFeatureCache {
+	
+	// fixed geometry
+	public:
+	static const int cellSize      =  8 ;
+	static const int bins          =  9 ;
+	static const int blockCells    =  2 ;
+	static const int windowCellsX  =  8 ;
+	static const int windowCellsY  = 16 ;
+	static const int blockSizeHist = blockCells * blockCells * bins ;
+	
+	// c'tor with linear SVM (weights followed by bias), gamma correction and number of cores to use
+	public:
+	HOGFeatureCache( const std::vector< float >& svmDetectorArg,
+	                 const bool                  gammaCorrectionArg = true,
+	                 const int                   coresArg           = hawaii::CPUCores ) ;
+	
+	// detect within "roi" of "frame" at multiple scales, results relative to "roi" like running
+	// "cv::HOGDescriptor::detectMultiScale()" on "frame( roi )"
+	// user note: "padding" is rounded down to full cells.
+	public:
+	void detectMultiScale( const cv::Mat                frame,
+	                       const cv::Rect               roi,
+	                             std::vector< cv::Rect >& found,
+	                             std::vector< double   >& foundWeights,
+	                       const double                 hitThreshold   = 0.0,
+	                       const cv::Size               padding        = cv::Size(),
+	                       const double                 scale          = 1.05,
+	                       const int                    groupThreshold = 2 ) ;
+	
+	// range of pyramid level scales to evaluate, same as "ParallelHOG::levelScaleMin" and "levelScaleMax"
+	public:
+	double levelScaleMin,
+	       levelScaleMax ;
+	
+	// re-use of cells across frames: A cell of the search region is only recomputed if the mean absolute difference of
+	//                                its pixels, and of the border pixels its gradients read from neighboring cells,
+	//                                to those it was last computed from exceeds "reuseThreshold", or if it has not
+	//                                been computed yet.
+	// user note #1: Set "reuseThreshold" to a negative value to always recompute.
+	// user note #2: Call "beginFrame()" once per frame before the "detectMultiScale()" calls of its search regions. The
+	//               counters sum up all regions since then, so they refer to the latest frame.
+	public:
+	double reuseThreshold ;
+	size_t cellsComputed,
+	       cellsReused   ;
+	void   beginFrame() ;
+	
+	// window scores in 16 bit fixed point via "FixedPointSVM" rather than in float
+	// user note: Use "checkFixedPoint()" to compare both on recorded frames before relying on it.
+	public:
+	bool useFixedPoint ;
+	
+	// compare fixed point and float scores of all windows within "roi" of "frame", same parameters as
+	// "detectMultiScale()"
+	// user note: "hitsDiffer" counts windows only one of both classifies as a hit w.r.t. "hitThreshold".
+	public:
+	struct FixedPointAccuracy {
+		size_t windows ;
+		double errorMax,
+		       errorSum ;
+		size_t hitsFloat,
+		       hitsFixedPoint,
+		       hitsDiffer ;
+	} ;
+	FixedPointAccuracy checkFixedPoint( const cv::Mat  frame,
+	                                    const cv::Rect roi,
+	                                    const double   hitThreshold = 0.0,
+	                                    const cv::Size padding      = cv::Size(),
+	                                    const double   scale        = 1.05 ) ;
+	const FixedPointSVM& svmFixedPoint() const { return this->svmFixed ; }
+	
+	// configuration
+	protected:
+	std::vector< float > svmDetector ;
+	float                svmBias ;
+	FixedPointSVM        svmFixed ;
+	bool                 gammaCorrection ;
+	int                  cores ;
+	float                gammaLUT[ 256 ] ;
+	
+	// per-pixel gradients at the original resolution: the two nearest orientation bins and their magnitude shares,
+	// pixels they were computed from (each cell with its one pixel border), index of the frame each cell was last valid
+	// for
+	protected:
+	void updateGradients( const cv::Mat& frame,
+	                      const cv::Rect region ) ;
+	cv::Size                    sizeFrame ;
+	cv::Mat                     gradBins,     // "CV_8UC2"
+	                            gradWeights,  // "CV_32FC2"
+	                            reference  ;
+	std::vector< unsigned int > cellFrame ;
+	unsigned int                frameIndex ;
+	std::vector< uchar        > cellChanged ; // cells of the current region recomputed by "updateGradients()"
+	
+	// per-bin integral histogram of the current search region
+	protected:
+	void updateIntegral( const cv::Rect region ) ;
+	std::vector< double > integral ;
+	int                   integralStride ; // number of doubles per integral row
+	
+	// per-level buffers: cell histograms, normalized (and quantized) blocks, raw hits
+	protected:
+	void   evaluateLevel( const int      level,
+	                      const cv::Rect region,
+	                      const int      paddingCells,
+	                      const double   hitThreshold ) ;
+	double scoreWindow(   const int      level,
+	                      const int      windowX,
+	                      const int      windowY,
+	                      const bool     fixedPoint ) const ;
+	std::vector< double                     > levelScales ;
+	std::vector< std::vector< float >       > levelCells,
+	                                          levelBlocks ;
+	std::vector< std::vector< int16_t >     > levelBlocksFixed ;
+	std::vector< cv::Size                   > levelSizeBlocks ;
+	std::vector< std::vector< cv::Rect >    > levelHits ;
+	std::vector< std::vector< double   >    > levelWeights ;
+	std::vector< int                        > rejectLevels ;
+
+} ; // class "HOGFeatureCache"
@@ -26,6 +26,7 @@
 #include "appDevel.h"
 #include "appDevelFP.h"
 #include "hawaii/common/hardware.h"
+#include "visualSink.h"
 
 #include "producer_consumer/base/base_services.h"
 
@@ -35,21 +36,29 @@
 #include "producer_consumer/drone_producer.h"
 #include "producer_consumer/drone_consumer.h"
 #include "producer_consumer/sender_receiver.h"
+#include "producer_consumer/udp_transport.h"
 
 #include "boost/date_time/posix_time/posix_time.hpp"
 
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+
 using namespace std;
 
 #define NO_PRODUCER 4
 #define NO_COMSUMER 1
 
 void dense3DOffline(std::string filename) ;
+void hogCheckOffline(std::string folder) ;
+void followPersonBenchmark(const std::string source, const std::string groundTruthFile, const unsigned int seed, const double focalLength) ;
 
 static void show_usage(ostream& os)
 {
 	os << "Usage: <demo> <option(s)>\n"
 			<< "Demo:\n"
 			<< "\t -h,--help\tShow help.\n\n"
+			<< "\t --headless\tNo windows, e.g. on board without display. May be combined with any demo.\n\n"
 			<< "\t -fl\t\tFollow line.\n\n"
 			<< "\t -ft\t\tFollow tag.\n\n"
 			<< "\t -fp\t\tFollow Person.\n\n"
@@ -59,6 +68,17 @@ static void show_usage(ostream& os)
 			<< "\t\t\tData will store in folder demoARDrone/data/dense3D*.yml\n\n"
 			<< "\t -d3Doffline\tFrom data, try to do dense 3D.\n"
 			<< "\t\t\t-d3Doffline <filename>\n\n"
+			<< "\t -hogcheck\tFrom recorded frames, compare fixed point and float HOG people SVM.\n"
+			<< "\t\t\t-hogcheck <folder>\n\n"
+			<< "\t -fpbench\tFrom recorded frames, benchmark person following without drone or ROS master.\n"
+			<< "\t\t\t-fpbench <folder or video> [<ground truth>|- [<seed> [<focal length>]]]\n"
+			<< "\t\t\tDefaults: no ground truth, seed 1, focal length 380 (full resolution).\n\n"
+			<< "\t -udptest\tSend frames over UDP to this process via 127.0.0.1, dropping a share of the fragments.\n"
+			<< "\t\t\t-udptest <port> [<frames> [<loss percent>]]\n"
+			<< "\t\t\tDefaults: 100 frames, no loss.\n\n"
+			<< "\t -streamtest\tSend frames of several streams to one server in this process via 127.0.0.1.\n"
+			<< "\t\t\t-streamtest <port> <streams> [<threads> [<frames>]]\n"
+			<< "\t\t\t2 to 8 streams, defaults: 1 thread, 300 frames per stream.\n\n"
 			<< "\t -s3D\t\tSparse 3D.\n"
 			<< "\t\t\tLandmark-based navigation.\n\n"
 			<< "\t -dev\t\tDeveloping application.\n"
@@ -71,15 +91,58 @@ static void show_usage(ostream& os)
 			<< "\t\t\tExample ./bin/demoARDrone -dev [-simulation <Simulation Folder>] server <portSrc> <hostDst> <portDst>\n"
 			<< "\t\t\tSimulation client: \n"
 			<< "\t\t\tExample ./bin/demoARDrone -dev [-simulation <Simulation Folder>] client <portSrc> <hostDst> <portDst>\n"
+			<< "\t\t\tAppend -codec raw|png|jpeg[:<quality>] to compress frames sent to the other laptop,\n"
+			<< "\t\t\tJPEG quality adapts to the link up to the given one (default 80).\n"
+			<< "\t\t\tAppend -threads <n> to run the network sessions on n threads (default 1, at most twice the cores).\n"
+			<< "\t\t\tAppend -udp to send frames over UDP, commands stay on TCP. Both laptops need it.\n"
+			<< "\t\t\tAppend -textwire to send in the old text format to a laptop running an old build.\n"
 			<< std::endl;
 }
 
-#define MAX_ARGUMENTS 10
+//parse a whole argument as a number within [min, max], return false if it is none or out of range
+static bool parseArgument(const std::string& text, long min, long max, long& value)
+{
+	char* end = NULL;
+	errno = 0;
+	const long parsed = std::strtol(text.c_str(), &end, 10);
+	if (text.empty() || *end != '\0' || errno == ERANGE || parsed < min || parsed > max) {
+		return false;
+	}
+	value = parsed;
+	return true;
+}
+
+static bool parseArgument(const std::string& text, double min, double max, double& value)
+{
+	char* end = NULL;
+	errno = 0;
+	const double parsed = std::strtod(text.c_str(), &end);
+	if (text.empty() || *end != '\0' || errno == ERANGE || !(parsed >= min && parsed <= max)) {
+		return false;
+	}
+	value = parsed;
+	return true;
+}
+
+//network threads worth running, more only compete for the cores
+static long maxNetworkThreads()
+{
+	return 2 * std::max<long>(1, boost::thread::hardware_concurrency());
+}
+
+#define MAX_ARGUMENTS 16
 
 int main(int argc, char* argv[]) {
+	// "--headless" may appear anywhere, it is removed before the other options are parsed
 	std::string strArgv[MAX_ARGUMENTS];
-	for (int i = 0; i < argc; i++) {
-		strArgv[i] = argv[i];
+	int argcAll = argc;
+	argc = 0;
+	for (int i = 0; i < argcAll && argc < MAX_ARGUMENTS; i++) {
+		if (std::string(argv[i]) == "--headless") {
+			VisualSink::instance().setHeadless(true);
+			continue;
+		}
+		strArgv[argc++] = argv[i];
 	}
 
 	if (strArgv[1] == "-h" || strArgv[1] == "--help") {
@@ -139,6 +202,50 @@ int main(int argc, char* argv[]) {
 		dense3DOffline(strArgv[2]);
 		return 0;
 	}
+	if (strArgv[1] == "-hogcheck" && argc == 3) {
+		hogCheckOffline(strArgv[2]);
+		return 0;
+	}
+	if (strArgv[1] == "-fpbench" && argc >= 3 && argc <= 6) {
+		const std::string groundTruth = (argc >= 4 && strArgv[3] != "-") ? strArgv[3] : "";
+		long seed = 1;
+		double focalLength = 380.0;
+		if ((argc >= 5 && !parseArgument(strArgv[4], 0L, (long)INT_MAX, seed))
+				|| (argc >= 6 && !parseArgument(strArgv[5], 1.0, 100000.0, focalLength))) {
+			show_usage(std::cerr);
+			return 1;
+		}
+		followPersonBenchmark(strArgv[2], groundTruth, (unsigned int)seed, focalLength);
+		return 0;
+	}
+	if (strArgv[1] == "-udptest" && argc >= 3 && argc <= 5) {
+		long port = 0;
+		long frames = 100;
+		double lossPercent = 0.0;
+		if (!parseArgument(strArgv[2], 1L, 65535L, port)
+				|| (argc >= 4 && !parseArgument(strArgv[3], 1L, 1000000L, frames))
+				|| (argc >= 5 && !parseArgument(strArgv[4], 0.0, 100.0, lossPercent))) {
+			show_usage(std::cerr);
+			return 1;
+		}
+		udpLoopbackTest((unsigned short)port, (int)frames, lossPercent);
+		return 0;
+	}
+	if (strArgv[1] == "-streamtest" && argc >= 4 && argc <= 6) {
+		long port = 0;
+		long streams = 0;
+		long threads = 1;
+		long frames = 300;
+		if (!parseArgument(strArgv[2], 1L, 65535L, port)
+				|| !parseArgument(strArgv[3], 2L, (long)stream_router::maxStreams, streams)
+				|| (argc >= 5 && !parseArgument(strArgv[4], 1L, maxNetworkThreads(), threads))
+				|| (argc >= 6 && !parseArgument(strArgv[5], 1L, 1000000L, frames))) {
+			show_usage(std::cerr);
+			return 1;
+		}
+		streamRouterTest((unsigned short)port, (size_t)streams, (size_t)threads, (int)frames);
+		return 0;
+	}
 	if (strArgv[1] == "-s3D") {
 		// GPU initialization
 		hawaii::GPU::init() ; {
@@ -159,6 +266,40 @@ int main(int argc, char* argv[]) {
 		std::string SimulationFolder = "";
 		std::string ClientServer;
 
+		//send in the old text format, to talk to a laptop running an old build
+		for (int i = 2; i < argc; i++) {
+			if (strArgv[i] == "-textwire") {
+				setWireFormat(WireFormat::wireFormatText);
+			}
+		}
+		//codec to offer for frames sent to the other laptop
+		for (int i = 2; i + 1 < argc; i++) {
+			if (strArgv[i] != "-codec") continue;
+			WireCodec codec = WireCodec::wireCodecRaw;
+			int quality = getWireCodecQuality();
+			if (!parseWireCodec(strArgv[i + 1], codec, quality)) {
+				show_usage(std::cerr);
+				return 1;
+			}
+			setWireCodec(codec, quality);
+		}
+		//frames over UDP, see udp_transport.h
+		for (int i = 2; i < argc; i++) {
+			if (strArgv[i] == "-udp") {
+				setUdpFrames(true);
+			}
+		}
+		//threads of the network sessions
+		for (int i = 2; i + 1 < argc; i++) {
+			if (strArgv[i] != "-threads") continue;
+			long threads = 1;
+			if (!parseArgument(strArgv[i + 1], 1L, maxNetworkThreads(), threads)) {
+				show_usage(std::cerr);
+				return 1;
+			}
+			setNetworkThreads((size_t)threads);
+		}
+
 		if (strArgv[2] == "-simulation") {
 			SimulationFolder = strArgv[3];
 
@@ -180,6 +321,8 @@ int main(int argc, char* argv[]) {
 		if (ClientServer == "client") {
 			//laptop 2
 			printing("running remote client");
+			//only the newest frame is worth sending over the wireless link
+			GloQueueData.set_policy(overflow_policy::keep_latest);
 
 			producer_consumer_thread::DroneConsumerClient silCon(2, portSrc, hostDst, portDst);
 			//boost::thread t_sil_con(silCon);
@@ -221,6 +364,8 @@ int main(int argc, char* argv[]) {
 
 		if (ClientServer == "server") {
 			printing("running local server");
+			//frames of both streams are needed for pairing them, so only drop when the consumer falls behind
+			GloQueueData.set_policy(overflow_policy::drop_oldest);
 			try
 			{
 				setSystemState(SystemState::activeState);
@@ -0,0 +1,162 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// search regions for the people detector from ego-motion compensated frame differences
+// ======================================================================================
+
+#include "motionProposals.h"
+#include "hawaii/common/error.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+// c'tor with minimum proposal size
+MotionProposals::MotionProposals( const cv::Size sizeMinArg ) :
+	sizeMin( sizeMinArg ),
+	scale( 0.5 ),
+	threshold( 25 ),
+	areaMin( 12 ),
+	proposalsMax( 4 ),
+	areaMaxRatio( 0.5 ),
+	focalLengthCurr( 0.0 ),
+	rotationValidPrev( false ),
+	rotationValidCurr( false ) {
+}
+
+// latest image: keep the previous one, convert and downscale the new one
+void MotionProposals::setImage( const cv::Mat frame ) {
+	HAWAII_ERROR_CONDITIONAL( frame.type() != CV_8UC3 && frame.type() != CV_8UC1,
+	                          "Image type must be \"CV_8UC3\" or \"CV_8UC1\"." ) ;
+	if( frame.size() != this->sizeInput ) {
+		this->grayPrev.release() ;
+		this->sizeInput = frame.size() ;
+	}
+	else {
+		std::swap( this->grayPrev, this->grayCurr ) ;
+	}
+	this->rotationPrev      = this->rotationCurr ;
+	this->rotationValidPrev = this->rotationValidCurr ;
+	this->rotationValidCurr = false ;
+	cv::Mat& scaled = this->difference ; // developer note: re-used as scratch buffer
+	cv::resize( frame, scaled, cv::Size(), this->scale, this->scale, cv::INTER_AREA ) ;
+	if( scaled.channels() == 3 ) { cv::cvtColor( scaled, this->grayCurr, CV_BGR2GRAY ) ; }
+	else                         { scaled.copyTo( this->grayCurr ) ; }
+}
+
+// camera rotation at the time of the latest image
+void MotionProposals::setRotation( const cv::Vec3d rotationGlobal,
+                                   const double    focalLength ) {
+	this->rotationCurr      = rotationGlobal ;
+	this->focalLengthCurr   = focalLength ;
+	this->rotationValidCurr = focalLength > 0.0 && std::isfinite( rotationGlobal( 0 ) )
+	                                            && std::isfinite( rotationGlobal( 1 ) )
+	                                            && std::isfinite( rotationGlobal( 2 ) ) ;
+}
+
+// homography from previous to latest scaled image
+// developer note: With odometry, it is "K * R * K^-1" for the rotation between both camera poses, using small angles
+//                 so that the order of pitch, yaw and roll does not matter. Yawing right moves the scene left,
+//                 pitching up moves it down and rolling right-down turns it counter-clockwise, hence the signs below.
+//                 The principal point is assumed at the image center. Rotations too large for small angles - e.g.
+//                 after dropped images - are left to image registration.
+cv::Mat MotionProposals::egoMotion() const {
+	const double rotationSmall = 0.2 ;
+	double delta[ 3 ] = { 0.0, 0.0, 0.0 } ;
+	bool   small      = this->rotationValidPrev && this->rotationValidCurr ;
+	for( int axis = 0 ; axis < 3 && small ; ++axis ) {
+		delta[ axis ] = std::remainder( this->rotationCurr( axis ) - this->rotationPrev( axis ), 2.0 * CV_PI ) ;
+		small         = std::abs( delta[ axis ] ) < rotationSmall ;
+	}
+	if( small ) {
+		const double f     = this->focalLengthCurr * this->scale,
+		             u0    = this->grayCurr.cols * 0.5,
+		             v0    = this->grayCurr.rows * 0.5,
+		             pitch = -delta[ 0 ],
+		             yaw   = -delta[ 1 ],
+		             roll  = -delta[ 2 ] ;
+		const cv::Matx33d K(  f,    0.0,  u0,
+		                      0.0,  f,    v0,
+		                      0.0,  0.0,  1.0 ),
+		                  R(  1.0,  -roll,  yaw,
+		                      roll,  1.0,  -pitch,
+		                     -yaw,   pitch, 1.0 ) ;
+		return cv::Mat( K * R * K.inv() ) ;
+	}
+	cv::Mat prev, curr ;
+	this->grayPrev.convertTo( prev, CV_32F ) ;
+	this->grayCurr.convertTo( curr, CV_32F ) ;
+	const cv::Point2d shift = cv::phaseCorrelate( prev, curr ) ;
+	return cv::Mat( cv::Matx33d( 1.0, 0.0, shift.x,
+	                             0.0, 1.0, shift.y,
+	                             0.0, 0.0, 1.0     ) ) ;
+}
+
+// regions of compensated frame differences
+const std::vector< cv::Rect >& MotionProposals::propose() {
+	this->proposals.clear() ;
+	if( this->grayPrev.empty() || this->grayCurr.empty() ) { return this->proposals ; }
+	
+	// warp the previous image onto the latest, ignore pixels it does not cover
+	const cv::Mat homography = this->egoMotion() ;
+	cv::warpPerspective( this->grayPrev, this->warped, homography, this->grayCurr.size(), cv::INTER_LINEAR ) ;
+	this->valid.create( this->grayPrev.size(), CV_8UC1 ) ;
+	this->valid.setTo( cv::Scalar::all( 255 ) ) ;
+	cv::warpPerspective( this->valid, this->valid, homography, this->grayCurr.size(), cv::INTER_NEAREST ) ;
+	cv::erode( this->valid, this->valid, cv::Mat(), cv::Point( -1, -1 ), 2 ) ;
+	
+	// thresholded difference, closed to connect the parts of a person
+	cv::absdiff( this->grayCurr, this->warped, this->difference ) ;
+	this->difference.setTo( cv::Scalar::all( 0 ), this->valid == 0 ) ;
+	cv::threshold( this->difference, this->mask, this->threshold, 255, cv::THRESH_BINARY ) ;
+	cv::morphologyEx( this->mask, this->mask, cv::MORPH_CLOSE, cv::Mat(), cv::Point( -1, -1 ), 2 ) ;
+	
+	// blobs, strongest first
+	this->blobs.clear() ;
+	cv::findContours( this->mask, this->contours, CV_RETR_EXTERNAL, CV_CHAIN_APPROX_SIMPLE ) ;
+	for( const auto& contour : this->contours ) {
+		const cv::Rect box = cv::boundingRect( contour ) ;
+		if( box.area() < this->areaMin ) { continue ; }
+		this->blobs.push_back( std::make_pair( cv::sum( this->difference( box ) )[ 0 ], box ) ) ;
+	}
+	std::sort( this->blobs.begin(), this->blobs.end(),
+	           []( const std::pair< double, cv::Rect >& a, const std::pair< double, cv::Rect >& b ) { return a.first > b.first ; } ) ;
+	
+	// input image regions of at least the minimum size, overlapping ones merged
+	const cv::Rect image( cv::Point( 0, 0 ), this->sizeInput ) ;
+	for( const auto& blob : this->blobs ) {
+		if( (int)this->proposals.size() >= this->proposalsMax ) { break ; }
+		cv::Rect region( cvFloor( blob.second.x / this->scale ), cvFloor( blob.second.y / this->scale ),
+		                 cvCeil( blob.second.width / this->scale ), cvCeil( blob.second.height / this->scale ) ) ;
+		const int growX = std::max( this->sizeMin.width  - region.width,  0 ),
+		          growY = std::max( this->sizeMin.height - region.height, 0 ) ;
+		region = cv::Rect( region.x - growX / 2, region.y - growY / 2, region.width + growX, region.height + growY ) & image ;
+		bool merged = false ;
+		for( auto& proposal : this->proposals ) {
+			if( ( proposal & region ).area() > 0 ) {
+				proposal = proposal | region ;
+				merged   = true ;
+				break ;
+			}
+		}
+		if( !merged ) { this->proposals.push_back( region ) ; }
+	}
+	
+	// motion everywhere - e.g. due to a failed compensation - is no better than searching the whole image
+	int area = 0 ;
+	for( const auto& proposal : this->proposals ) { area += proposal.area() ; }
+	if( area > this->areaMaxRatio * image.area() ) { this->proposals.clear() ; }
+	return this->proposals ;
+}
@@ -0,0 +1,80 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// search regions for the people detector from ego-motion compensated frame differences
+// ======================================================================================
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+// moving object proposals: Consecutive frames are converted to small grayscale images, the previous one is warped onto
+//                          the latest to compensate the drone's own motion, and the blobs of their difference - grown
+//                          to at least the size of a HOG window - become candidate regions for the detector. Ego-motion
+//                          is the rotation-only homography from the on-board odometry if set, otherwise the global
+//                          translation found by phase correlation.
+// user note: Call "setImage()" for every image, "propose()" only when needed. No proposals (e.g. on the first image or
+//            if motion is everywhere) means the caller should search the whole image.
+class MotionProposals {
+	
+	// c'tor with the minimum size of a proposal, i.e. the detector window plus margin, in input image pixels
+	public:
+	MotionProposals( const cv::Size sizeMinArg ) ;
+	protected:
+	cv::Size sizeMin ;
+	
+	// parameters
+	// user note: "scale" is applied to the input images, "threshold" is the minimum gray value difference, "areaMin" the
+	//            minimum blob area in scaled pixels, "areaMaxRatio" the maximum total proposal area w.r.t. the image.
+	public:
+	double scale ;
+	int    threshold ;
+	int    areaMin ;
+	int    proposalsMax ;
+	double areaMaxRatio ;
+	
+	// latest image, and optionally the camera rotation at its time as on-board odometry's pitch, yaw and roll with the
+	// focal length of the input images in pixels
+	// user note: Non-finite angles, e.g. of replayed images without odometry, count as no rotation set.
+	public:
+	void setImage( const cv::Mat frame ) ;
+	void setRotation( const cv::Vec3d rotationGlobal,
+	                  const double    focalLength ) ;
+	protected:
+	cv::Mat   grayPrev,
+	          grayCurr ;
+	cv::Size  sizeInput ;
+	cv::Vec3d rotationPrev,
+	          rotationCurr ;
+	double    focalLengthCurr ;
+	bool      rotationValidPrev,
+	          rotationValidCurr ;
+	
+	// regions in input image coordinates, strongest motion first
+	public:
+	const std::vector< cv::Rect >& propose() ;
+	protected:
+	cv::Mat egoMotion() const ; // 3x3 homography from previous to latest scaled image
+	cv::Mat warped,
+	        valid,
+	        difference,
+	        mask ;
+	std::vector< std::vector< cv::Point > > contours ;
+	std::vector< std::pair< double, cv::Rect > > blobs ; // (difference sum, region)
+	std::vector< cv::Rect > proposals ;
+
+} ; // class "MotionProposals"
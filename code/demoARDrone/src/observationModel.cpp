@@ -0,0 +1,247 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// observation models weighting the particles of "ParticleFilter"
+// ===============================================================
+
+#include "observationModel.h"
+#include "simd.h"
+#include "hawaii/common/error.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace simd ;
+
+// c'tor with standard deviation and clutter likelihood
+DetectionObservation::DetectionObservation( const float sigmaArg,
+                                            const float clutterArg,
+                                            const float sigmaHeightArg ) :
+	sigma( sigmaArg ),
+	clutter( clutterArg ),
+	sigmaHeight( sigmaHeightArg ) {
+	HAWAII_ERROR_CONDITIONAL( this->sigma <= 0.0f || this->sigmaHeight <= 0.0f,
+	                          "Standard deviations must be positive." ) ;
+	HAWAII_ERROR_CONDITIONAL( this->clutter < 0.0f,
+	                          "Clutter likelihood must not be negative." ) ;
+}
+
+// image bounds, an empty size disables the check
+void DetectionObservation::setBounds( const cv::Size sizeImage ) {
+	this->bounds = sizeImage ;
+}
+
+// forget the detections of the previous image
+void DetectionObservation::clear() {
+	this->centers.clear() ;
+	this->confidences.clear() ;
+	this->heights.clear() ;
+}
+
+// add a detection of the latest image
+void DetectionObservation::add( const cv::Point2f center,
+                                const float       confidence,
+                                const float       height ) {
+	HAWAII_ERROR_CONDITIONAL( confidence < 0.0f,
+	                          "Confidence must not be negative." ) ;
+	HAWAII_ERROR_CONDITIONAL( height < 0.0f,
+	                          "Height must not be negative." ) ;
+	this->centers.push_back(     center     ) ;
+	this->confidences.push_back( confidence ) ;
+	this->heights.push_back(     height     ) ;
+}
+
+// multiply all weights by the mixture likelihood
+void DetectionObservation::weigh( ParticleFilter& filter ) const {
+	float*       const weights  = filter.weights() ;
+	const float* const samplesX = filter.samples( ParticleFilter::posX  ),
+	           * const samplesY = filter.samples( ParticleFilter::posY  ),
+	           * const samplesH = filter.samples( ParticleFilter::sizeH ) ;
+	const Vec  exponentV = vSet( -0.5f / ( this->sigma * this->sigma ) ),
+	           clutterV  = vSet( this->clutter ),
+	           zeroV     = vSet( 0.0f ),
+	           widthV    = vSet( (float)this->bounds.width  ),
+	           heightV   = vSet( (float)this->bounds.height ) ;
+	const bool bounded   = this->bounds.area() > 0 ;
+	const int  detections = (int)this->centers.size() ;
+	for( int particle = 0 ; particle < filter.countPadded() ; particle += lanes ) {
+		const Vec xV = vLoad( samplesX + particle ),
+		          yV = vLoad( samplesY + particle ),
+		          hV = vLoad( samplesH + particle ) ;
+		Vec likelihoodV = clutterV ;
+		for( int detection = 0 ; detection < detections ; ++detection ) {
+			const Vec dxV = vSub( xV, vSet( this->centers[ detection ].x ) ),
+			          dyV = vSub( yV, vSet( this->centers[ detection ].y ) ) ;
+			Vec exponentSumV = vMul( vAdd( vMul( dxV, dxV ), vMul( dyV, dyV ) ), exponentV ) ;
+			if( this->heights[ detection ] > 0.0f ) {
+				const float sigmaH = this->sigmaHeight * this->heights[ detection ] ;
+				const Vec   dhV    = vSub( hV, vSet( this->heights[ detection ] ) ) ;
+				exponentSumV = vAdd( exponentSumV, vMul( vMul( dhV, dhV ), vSet( -0.5f / ( sigmaH * sigmaH ) ) ) ) ;
+			}
+			const Vec gaussV = vExp( exponentSumV ) ;
+			likelihoodV = vAdd( likelihoodV, vMul( vSet( this->confidences[ detection ] ), gaussV ) ) ;
+		}
+		if( bounded ) {
+			likelihoodV = vMul( likelihoodV, vMul( vWithin( xV, zeroV, widthV  ),
+			                                       vWithin( yV, zeroV, heightV ) ) ) ;
+		}
+		vStore( weights + particle, vMul( vLoad( weights + particle ), likelihoodV ) ) ;
+	}
+}
+
+// c'tor, nothing computed yet
+ColorHistogramImage::ColorHistogramImage() :
+	integralStride( 0 ) {
+}
+
+// integral histogram of the latest image
+void ColorHistogramImage::setImage( const cv::Mat frame ) {
+	HAWAII_ERROR_CONDITIONAL( frame.type() != CV_8UC3,
+	                          "Image type must be \"CV_8UC3\"." ) ;
+	
+	// bin index per pixel
+	// developer note: 8 bit "OpenCV" hue is within [0,180).
+	const int saturationMin = 40,
+	          valueMin      = 40 ;
+	cv::cvtColor( frame, this->hsv, CV_BGR2HSV ) ;
+	this->binImage.create( frame.size(), CV_8UC1 ) ;
+	for( int y = 0 ; y < frame.rows ; ++y ) {
+		const cv::Vec3b* const rowHSV  = this->hsv.ptr< cv::Vec3b >( y ) ;
+		uchar*           const rowBins = this->binImage.ptr< uchar >( y ) ;
+		for( int x = 0 ; x < frame.cols ; ++x ) {
+			const int hue        = rowHSV[ x ][ 0 ],
+			          saturation = rowHSV[ x ][ 1 ],
+			          value      = rowHSV[ x ][ 2 ] ;
+			if( saturation >= saturationMin && value >= valueMin ) {
+				rowBins[ x ] = (uchar)( std::min( hue * binsHue / 180, binsHue - 1 ) * binsSaturation
+				                      + ( saturation - saturationMin ) * binsSaturation / ( 256 - saturationMin ) ) ;
+			}
+			else {
+				rowBins[ x ] = (uchar)( binsHue * binsSaturation + value * binsValue / 256 ) ;
+			}
+		}
+	}
+	
+	// per-bin integral histogram, same layout as in "HOGFeatureCache"
+	this->sizeImage      = frame.size() ;
+	this->integralStride = ( frame.cols + 1 ) * bins ;
+	this->integral.resize( ( frame.rows + 1 ) * this->integralStride ) ;
+	std::fill( this->integral.begin(), this->integral.begin() + this->integralStride, 0 ) ;
+	for( int y = 0 ; y < frame.rows ; ++y ) {
+		const uchar* const rowBins = this->binImage.ptr< uchar >( y ) ;
+		const int*   const above   = &this->integral[ ( y     ) * this->integralStride ] ;
+		      int*   const curr    = &this->integral[ ( y + 1 ) * this->integralStride ] ;
+		int sumRow[ bins ] = { 0 } ;
+		std::fill( curr, curr + bins, 0 ) ;
+		for( int x = 0 ; x < frame.cols ; ++x ) {
+			++sumRow[ rowBins[ x ] ] ;
+			for( int bin = 0 ; bin < bins ; ++bin ) {
+				curr[ ( x + 1 ) * bins + bin ] = above[ ( x + 1 ) * bins + bin ] + sumRow[ bin ] ;
+			}
+		}
+	}
+}
+
+// pixel counts per bin of a box clipped to the image, "false" if less than a quarter of it remains
+bool ColorHistogramImage::countBox( const cv::Rect box,
+                                          int*     counts,
+                                          int&     area ) const {
+	const cv::Rect clipped = box & cv::Rect( cv::Point( 0, 0 ), this->sizeImage ) ;
+	area = clipped.area() ;
+	if( area == 0 || area * 4 < box.area() ) { return false ; }
+	const int* const topLeft     = &this->integral[ clipped.y          * this->integralStride +   clipped.x                    * bins ] ;
+	const int* const topRight    = &this->integral[ clipped.y          * this->integralStride + ( clipped.x + clipped.width ) * bins ] ;
+	const int* const bottomLeft  = &this->integral[ clipped.br().y     * this->integralStride +   clipped.x                    * bins ] ;
+	const int* const bottomRight = &this->integral[ clipped.br().y     * this->integralStride + ( clipped.x + clipped.width ) * bins ] ;
+	for( int bin = 0 ; bin < bins ; ++bin ) {
+		counts[ bin ] = bottomRight[ bin ] - bottomLeft[ bin ] - topRight[ bin ] + topLeft[ bin ] ;
+	}
+	return true ;
+}
+
+// c'tor with integral histogram, sharpness of the likelihood and learning rate
+ColorObservation::ColorObservation( const ColorHistogramImage& imageArg,
+                                    const float                lambdaArg,
+                                    const float                learningRateArg ) :
+	image( imageArg ),
+	lambda( lambdaArg ),
+	learningRate( learningRateArg ),
+	learnedFlag( false ) {
+	HAWAII_ERROR_CONDITIONAL( this->lambda <= 0.0f,
+	                          "Likelihood sharpness must be positive." ) ;
+	HAWAII_ERROR_CONDITIONAL( this->learningRate <= 0.0f || this->learningRate > 1.0f,
+	                          "Learning rate must be within (0,1]." ) ;
+	this->reset() ;
+}
+
+// learn from or blend in a box of the latest image
+void ColorObservation::learn( const cv::Rect box ) {
+	int counts[ bins ], area ;
+	if( !this->image.countBox( box, counts, area ) ) { return ; }
+	const float rate = this->learnedFlag ? this->learningRate : 1.0f ;
+	for( int bin = 0 ; bin < bins ; ++bin ) {
+		this->reference[     bin ] = ( 1.0f - rate ) * this->reference[ bin ] + rate * counts[ bin ] / area ;
+		this->referenceSqrt[ bin ] = std::sqrt( this->reference[ bin ] ) ;
+	}
+	this->sizeBox     = box.size() ;
+	this->learnedFlag = true ;
+}
+
+// forget the reference
+void ColorObservation::reset() {
+	std::fill( this->reference,     this->reference     + bins, 0.0f ) ;
+	std::fill( this->referenceSqrt, this->referenceSqrt + bins, 0.0f ) ;
+	this->learnedFlag = false ;
+}
+
+// Bhattacharyya coefficient between the reference and the box centered at "center", scaled to "height" if given
+float ColorObservation::similarity( const cv::Point2f center,
+                                    const float       height ) const {
+	int counts[ bins ], area ;
+	if( !this->learnedFlag
+	 || !std::isfinite( center.x ) || !std::isfinite( center.y ) ) {
+		return 0.0f ;
+	}
+	const float scale = ( height > 0.0f && std::isfinite( height ) ) ? height / this->sizeBox.height : 1.0f ;
+	const int   widthBox  = std::max( 1, cvRound( this->sizeBox.width  * scale ) ),
+	            heightBox = std::max( 1, cvRound( this->sizeBox.height * scale ) ) ;
+	if( !this->image.countBox( cv::Rect( cvRound( center.x - widthBox  * 0.5f ),
+	                                     cvRound( center.y - heightBox * 0.5f ),
+	                                     widthBox, heightBox ), counts, area ) ) {
+		return 0.0f ;
+	}
+	float coefficient = 0.0f ;
+	for( int bin = 0 ; bin < bins ; ++bin ) {
+		coefficient += std::sqrt( (float)counts[ bin ] ) * this->referenceSqrt[ bin ] ;
+	}
+	return coefficient / std::sqrt( (float)area ) ;
+}
+
+// multiply all weights by the appearance likelihood
+void ColorObservation::weigh( ParticleFilter& filter ) const {
+	HAWAII_ERROR_CONDITIONAL( !this->learnedFlag,
+	                          "Reference histogram must be learned first." ) ;
+	float*       const weights  = filter.weights() ;
+	const float* const samplesX = filter.samples( ParticleFilter::posX  ),
+	           * const samplesY = filter.samples( ParticleFilter::posY  ),
+	           * const samplesH = filter.samples( ParticleFilter::sizeH ) ;
+	for( int particle = 0 ; particle < filter.count() ; ++particle ) {
+		if( weights[ particle ] == 0.0f ) { continue ; }
+		const float coefficient = this->similarity( cv::Point2f( samplesX[ particle ], samplesY[ particle ] ),
+		                                            samplesH[ particle ] ) ;
+		weights[ particle ] *= coefficient > 0.0f ? std::exp( -this->lambda * ( 1.0f - coefficient ) ) : 0.0f ;
+	}
+}
@@ -0,0 +1,157 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// observation models weighting the particles of "ParticleFilter"
+// ===============================================================
+
+#pragma once
+
+#include "particleFilter.h"
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+// interface: multiply each particle's weight by the likelihood of the latest measurements given its state
+// user note: Call "weigh()" of one or more models between "ParticleFilter::resetWeights()" and "normalize()". Chaining
+//            models multiplies their likelihoods, i.e. treats their cues as independent.
+class ObservationModel {
+	
+	// d'tor for use via base class pointers
+	public:
+	virtual ~ObservationModel() {}
+	
+	// multiply all weights by the likelihood
+	public:
+	virtual void weigh( ParticleFilter& filter ) const = 0 ;
+
+} ; // class "ObservationModel"
+
+// detections as isotropic Gaussians around their centers: The likelihood of a particle is a mixture over all detections
+//                                                         of the latest image, each weighted by its confidence, plus a
+//                                                         constant for clutter. It is evaluated analytically from the
+//                                                         particle coordinates in one vectorized pass.
+// user note: Particles outside the image get zero likelihood, as the detector cannot have seen them there.
+// user note: Detections added with a height are additionally Gaussian w.r.t. the particles' box heights, with a
+//            standard deviation relative to that height - the detector's scale steps are relative as well.
+class DetectionObservation : public ObservationModel {
+	
+	// c'tor with standard deviation in pixels, clutter likelihood relative to the peak of a detection and standard
+	// deviation of the height relative to the detected one
+	public:
+	DetectionObservation( const float sigmaArg       = 20.0f,
+	                      const float clutterArg     =  0.0f,
+	                      const float sigmaHeightArg =  0.1f ) ;
+	
+	// image bounds, detections of the latest image
+	public:
+	void   setBounds( const cv::Size sizeImage ) ;
+	void   clear() ;
+	void   add( const cv::Point2f center,
+	            const float       confidence = 1.0f,
+	            const float       height     = 0.0f ) ; // zero to ignore the height
+	bool   empty() const { return this->centers.empty() ; }
+	size_t size()  const { return this->centers.size() ; }
+	protected:
+	float                      sigma,
+	                           clutter,
+	                           sigmaHeight ;
+	cv::Size                   bounds ;
+	std::vector< cv::Point2f > centers ;
+	std::vector< float       > confidences,
+	                           heights ;
+	
+	// multiply all weights by the mixture likelihood
+	public:
+	virtual void weigh( ParticleFilter& filter ) const ;
+
+} ; // class "DetectionObservation"
+
+// per-image integral color histogram, shared by the appearance models of all tracks: Chromatic pixels are binned by
+//                                                                                   hue and saturation, achromatic
+//                                                                                   ones - too dark or unsaturated for
+//                                                                                   a reliable hue - by value only.
+class ColorHistogramImage {
+	
+	// histogram layout
+	public:
+	static const int binsHue        = 8 ;
+	static const int binsSaturation = 3 ;
+	static const int binsValue      = 4 ;
+	static const int bins           = binsHue * binsSaturation + binsValue ;
+	
+	// c'tor, compute the integral histogram of the latest image
+	public:
+	ColorHistogramImage() ;
+	void setImage( const cv::Mat frame ) ;
+	protected:
+	cv::Mat              hsv,
+	                     binImage ;
+	std::vector< int >   integral ;
+	int                  integralStride ; // number of ints per integral row
+	cv::Size             sizeImage ;
+	
+	// pixel counts per bin of a box clipped to the image, "false" if less than a quarter of it remains
+	public:
+	bool countBox( const cv::Rect box,
+	                     int*     counts,
+	                     int&     area ) const ;
+
+} ; // class "ColorHistogramImage"
+
+// appearance via color histograms: A reference histogram is learned from confirmed detections. Each particle is
+//                                  weighted by the Bhattacharyya coefficient between it and the histogram of a box
+//                                  centered at the particle, with the reference's aspect ratio and the particle's
+//                                  height. Box histograms are read from a per-image integral histogram in O(bins).
+// user note: Call "ColorHistogramImage::setImage()" once per image before "learn()", "similarity()" or "weigh()". Boxes
+//            mostly outside the image get zero likelihood.
+class ColorObservation : public ObservationModel {
+	
+	// c'tor with the integral histogram to read from, sharpness of the likelihood w.r.t. the Bhattacharyya distance and
+	// learning rate of the reference
+	// user note: The likelihood is "exp( -lambda * ( 1 - coefficient ) )". A learning rate of 1 replaces the reference by
+	//            the latest box, smaller ones blend it in.
+	public:
+	ColorObservation( const ColorHistogramImage& imageArg,
+	                  const float                lambdaArg       = 20.0f,
+	                  const float                learningRateArg =  0.5f ) ;
+	protected:
+	const ColorHistogramImage& image ;
+	float                      lambda,
+	                           learningRate ;
+	
+	// reference histogram and box size: learn from or blend in a box of the latest image, forget
+	public:
+	void learn( const cv::Rect box ) ;
+	void reset() ;
+	bool learned() const { return this->learnedFlag ; }
+	protected:
+	static const int bins = ColorHistogramImage::bins ;
+	bool     learnedFlag ;
+	cv::Size sizeBox ;
+	float    reference[     bins ],
+	         referenceSqrt[ bins ] ;
+	
+	// Bhattacharyya coefficient in [0,1] between the reference and the box centered at "center"
+	// user note: A positive "height" scales the learned box to it, keeping the aspect ratio, otherwise the learned size
+	//            is used.
+	public:
+	float similarity( const cv::Point2f center,
+	                  const float       height = 0.0f ) const ;
+	
+	// multiply all weights by the appearance likelihood
+	public:
+	virtual void weigh( ParticleFilter& filter ) const ;
+
+} ; // class "ColorObservation"
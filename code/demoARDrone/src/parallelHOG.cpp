@@ -0,0 +1,154 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// multi-scale HOG detection in parallel across pyramid levels and image tiles
+// ============================================================================
+
+#include "parallelHOG.h"
+#include "hawaii/common/error.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+// c'tor with detector configuration and number of cores to use
+ParallelHOG::ParallelHOG( const cv::HOGDescriptor& hogArg,
+                          const int                coresArg ) :
+	hog( hogArg ),
+	levelScaleMin( 1.0 ),
+	levelScaleMax( HUGE_VAL ),
+	cores( std::max( coresArg, 1 ) ) {
+}
+
+// detect at multiple scales
+void ParallelHOG::detectMultiScale( const cv::Mat                image,
+                                          std::vector< cv::Rect >& found,
+                                          std::vector< double   >& foundWeights,
+                                    const double                 hitThreshold,
+                                    const cv::Size               winStride,
+                                    const cv::Size               padding,
+                                    const double                 scale,
+                                    const int                    groupThreshold ) {
+	
+	// check input
+	HAWAII_ERROR_CONDITIONAL( image.empty(),
+	                          "Image must not be empty." ) ;
+	HAWAII_ERROR_CONDITIONAL( scale <= 1.0,
+	                          "Scale step must be greater than 1." ) ;
+	found.clear() ;
+	foundWeights.clear() ;
+	const cv::Size winSize = this->hog.winSize ;
+	
+	// determine pyramid levels as long as a window still fits, same as "cv::HOGDescriptor", within the range of scales
+	this->levelScales.clear() ;
+	for( double levelScale = 1.0 ;
+	     cvRound( image.cols / levelScale ) >= winSize.width
+	  && cvRound( image.rows / levelScale ) >= winSize.height
+	  && (int)this->levelScales.size() < this->hog.nlevels
+	  && levelScale <= this->levelScaleMax ;
+	     levelScale *= scale ) {
+		if( levelScale >= this->levelScaleMin ) { this->levelScales.push_back( levelScale ) ; }
+	}
+	const int levelsCount = (int)this->levelScales.size() ;
+	if( levelsCount == 0 ) { return ; }
+	this->levelsUnpadded.resize( levelsCount ) ;
+	this->levels.resize(         levelsCount ) ;
+	
+	// resize and pad all levels in parallel
+	// developer note: Padding is done here once rather than by "cv::HOGDescriptor::detect()" per tile, as the latter
+	//                 would evaluate windows within the overlap of neighboring tiles twice.
+	const int cores = this->cores ;
+	#pragma omp parallel for                \
+		if( cores > 1 ) num_threads( cores ) \
+		schedule( dynamic )
+	for( int level = 0 ; level < levelsCount ; ++level ) {
+		const cv::Size sizeLevel( cvRound( image.cols / this->levelScales[ level ] ),
+		                          cvRound( image.rows / this->levelScales[ level ] ) ) ;
+		if( this->levelScales[ level ] == 1.0 ) { this->levelsUnpadded[ level ] = image ; }
+		else             { cv::resize( image, this->levelsUnpadded[ level ], sizeLevel ) ; }
+		cv::copyMakeBorder( this->levelsUnpadded[ level ], this->levels[ level ],
+		                    padding.height, padding.height, padding.width, padding.width, cv::BORDER_REFLECT_101 ) ;
+	}
+	
+	// split levels into tiles of similar size along the window grid of each level
+	// developer note: Aim for about two tiles per core to balance the load, as small levels only give a single tile.
+	//                 Tiles start and end at multiples of the window stride, as "cv::HOGDescriptor::detect()" places
+	//                 windows from the origin of the image it gets, so every tile samples the grid of the whole level
+	//                 and each window of the level belongs to exactly one tile.
+	const cv::Size stride = ( winStride == cv::Size() ) ? this->hog.blockStride : winStride ;
+	double windowsTotal = 0.0 ;
+	for( const auto& level : this->levels ) {
+		windowsTotal += (double)( ( level.cols - winSize.width  ) / stride.width  + 1 )
+		                      * ( ( level.rows - winSize.height ) / stride.height + 1 ) ;
+	}
+	const double windowsPerTile = windowsTotal / ( 2 * cores ) ;
+	this->tiles.clear() ;
+	for( int level = 0 ; level < levelsCount ; ++level ) {
+		const cv::Mat& levelImage = this->levels[ level ] ;
+		const int      windowsCols  = ( levelImage.cols - winSize.width  ) / stride.width  + 1,
+		               windowsRows  = ( levelImage.rows - winSize.height ) / stride.height + 1,
+		               tilesWanted  = std::max( 1, (int)std::ceil( (double)windowsCols * windowsRows / windowsPerTile ) ),
+		               tilesRows    = std::min( windowsRows, std::max( 1, (int)std::sqrt( (double)tilesWanted ) ) ),
+		               tilesCols    = std::min( windowsCols, std::max( 1, ( tilesWanted + tilesRows - 1 ) / tilesRows ) ) ;
+		for( int tileRow = 0 ; tileRow < tilesRows ; ++tileRow ) {
+			const int windowRowBegin = windowsRows *   tileRow       / tilesRows,
+			          windowRowEnd   = windowsRows * ( tileRow + 1 ) / tilesRows ;
+			for( int tileCol = 0 ; tileCol < tilesCols ; ++tileCol ) {
+				const int windowColBegin = windowsCols *   tileCol       / tilesCols,
+				          windowColEnd   = windowsCols * ( tileCol + 1 ) / tilesCols ;
+				Tile tile ;
+				tile.level  = level ;
+				tile.offset = cv::Point( windowColBegin * stride.width, windowRowBegin * stride.height ) ;
+				tile.image  = levelImage( cv::Rect( tile.offset.x, tile.offset.y,
+				                                    ( windowColEnd - 1 - windowColBegin ) * stride.width  + winSize.width,
+				                                    ( windowRowEnd - 1 - windowRowBegin ) * stride.height + winSize.height ) ) ;
+				this->tiles.push_back( tile ) ;
+			}
+		}
+	}
+	
+	// evaluate all tiles in parallel, each into its own result buffers
+	const int tilesCount = (int)this->tiles.size() ;
+	this->hitsPerTile.resize(    tilesCount ) ;
+	this->weightsPerTile.resize( tilesCount ) ;
+	#pragma omp parallel for                \
+		if( cores > 1 ) num_threads( cores ) \
+		schedule( dynamic )
+	for( int tile = 0 ; tile < tilesCount ; ++tile ) {
+		this->hitsPerTile[    tile ].clear() ;
+		this->weightsPerTile[ tile ].clear() ;
+		this->hog.detect( this->tiles[ tile ].image, this->hitsPerTile[ tile ], this->weightsPerTile[ tile ],
+		                  hitThreshold, stride, cv::Size() ) ;
+	}
+	
+	// transform hits back into the original image
+	for( int tile = 0 ; tile < tilesCount ; ++tile ) {
+		const Tile&    tileInfo   = this->tiles[ tile ] ;
+		const double   levelScale = this->levelScales[ tileInfo.level ] ;
+		const cv::Size sizeScaled( cvRound( winSize.width  * levelScale ),
+		                           cvRound( winSize.height * levelScale ) ) ;
+		for( size_t hit = 0 ; hit < this->hitsPerTile[ tile ].size() ; ++hit ) {
+			const cv::Point position = this->hitsPerTile[ tile ][ hit ] + tileInfo.offset ;
+			found.push_back( cv::Rect( cv::Point( cvRound( ( position.x - padding.width  ) * levelScale ),
+			                                      cvRound( ( position.y - padding.height ) * levelScale ) ),
+			                           sizeScaled ) ) ;
+			foundWeights.push_back( this->weightsPerTile[ tile ][ hit ] ) ;
+		}
+	}
+	
+	// merge hits of all levels and tiles at once
+	this->rejectLevels.assign( found.size(), 0 ) ;
+	cv::groupRectangles( found, this->rejectLevels, foundWeights, groupThreshold, 0.2 ) ;
+}
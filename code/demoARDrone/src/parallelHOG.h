@@ -0,0 +1,86 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// multi-scale HOG detection in parallel across pyramid levels and image tiles
+// ============================================================================
+
+#pragma once
+
+#include "hawaii/common/hardware.h"
+#include <opencv2/core/core.hpp>
+#include <opencv2/objdetect/objdetect.hpp>
+#include <vector>
+
+// drop-in replacement for "cv::HOGDescriptor::detectMultiScale()": All pyramid levels are resized in parallel, then
+//                                                                 split into tiles along their window grid such that
+//                                                                 each core gets a similar number of windows to
+//                                                                 evaluate. Hits of all levels and tiles are merged by
+//                                                                 one grouping pass.
+// user note: Configure the wrapped detector via the public "hog" member.
+class ParallelHOG {
+	
+	// c'tor with detector configuration and number of cores to use
+	public:
+	ParallelHOG( const cv::HOGDescriptor& hogArg,
+	             const int                coresArg = hawaii::CPUCores ) ;
+	
+	// wrapped detector
+	public:
+	cv::HOGDescriptor hog ;
+	
+	// range of pyramid level scales to evaluate, i.e. of detection heights w.r.t. the window height
+	// user note: Levels remain the powers of the scale step, those outside the range are skipped. The defaults cover all
+	//            levels, narrowing the range around the expected size of a tracked person saves most of the detection.
+	public:
+	double levelScaleMin,
+	       levelScaleMax ;
+	
+	// detect at multiple scales, same parameters as "cv::HOGDescriptor::detectMultiScale()"
+	// user note: "foundWeights" receives the highest SVM score within each group of raw hits.
+	public:
+	void detectMultiScale( const cv::Mat                image,
+	                             std::vector< cv::Rect >& found,
+	                             std::vector< double   >& foundWeights,
+	                       const double                 hitThreshold   = 0.0,
+	                       const cv::Size               winStride      = cv::Size(),
+	                       const cv::Size               padding        = cv::Size(),
+	                       const double                 scale          = 1.05,
+	                       const int                    groupThreshold = 2 ) ;
+	protected:
+	int cores ;
+	
+	// pyramid levels (padded by reflecting the border like "cv::HOGDescriptor" does), tiles to be processed in parallel
+	// developer note: Tiles start at multiples of the window stride and cover whole rows and columns of windows, so they
+	//                 overlap by less than a window in pixels but share no window, and none is counted twice during
+	//                 grouping.
+	protected:
+	struct Tile {
+		int       level ;
+		cv::Mat   image ;
+		cv::Point offset ; // top-left corner within the padded level, a multiple of the window stride
+	} ;
+	std::vector< double   > levelScales ;
+	std::vector< cv::Mat  > levelsUnpadded,
+	                        levels        ;
+	std::vector< Tile     > tiles ;
+	
+	// raw hits per tile, buffers for grouping
+	protected:
+	std::vector< std::vector< cv::Point > > hitsPerTile ;
+	std::vector< std::vector< double    > > weightsPerTile ;
+	std::vector< int                      > rejectLevels ;
+
+} ; // class "ParallelHOG"
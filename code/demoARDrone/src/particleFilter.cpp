@@ -0,0 +1,302 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// particle filter with structure-of-arrays storage and SIMD passes
+// ================================================================
+
+#include "particleFilter.h"
+#include "simd.h"
+#include "hawaii/common/error.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+// helpers only used here
+namespace {
+
+// vector types and operations
+using namespace simd ;
+
+// "xorshift32" step and its conversion to a float in [0,1)
+inline uint32_t xorshift( uint32_t x ) {
+	x ^= x << 13 ;
+	x ^= x >> 17 ;
+	x ^= x <<  5 ;
+	return x ;
+}
+const float uint24ToUnit = 1.0f / 16777216.0f ;
+
+// "lanes" uniform random numbers in [0,1), advancing the per-lane generator states
+#if defined( __SSE2__ )
+inline __m128 randomUniform4( uint32_t* state ) {
+	__m128i x = _mm_loadu_si128( (const __m128i*)state ) ;
+	x = _mm_xor_si128( x, _mm_slli_epi32( x, 13 ) ) ;
+	x = _mm_xor_si128( x, _mm_srli_epi32( x, 17 ) ) ;
+	x = _mm_xor_si128( x, _mm_slli_epi32( x,  5 ) ) ;
+	_mm_storeu_si128( (__m128i*)state, x ) ;
+	return _mm_mul_ps( _mm_cvtepi32_ps( _mm_srli_epi32( x, 8 ) ), _mm_set1_ps( uint24ToUnit ) ) ;
+}
+#endif
+inline Vec vRandom( uint32_t* state ) {
+	#if defined( __AVX__ )
+	const __m128 lo = randomUniform4( state     ),
+	             hi = randomUniform4( state + 4 ) ;
+	return _mm256_insertf128_ps( _mm256_castps128_ps256( lo ), hi, 1 ) ;
+	#elif defined( __SSE2__ )
+	return randomUniform4( state ) ;
+	#else
+	*state = xorshift( *state ) ;
+	return (float)( *state >> 8 ) * uint24ToUnit ;
+	#endif
+}
+
+// padded number of particles
+inline int padded( const int particles ) {
+	return ( particles + lanes - 1 ) / lanes * lanes ;
+}
+
+} // anonymous namespace
+
+// c'tor with (maximum) number of particles and random seed, allocate aligned and padded sample arrays for the maximum
+ParticleFilter::ParticleFilter( const int          particlesMaxArg,
+                                const unsigned int seed ) :
+	adaptive( false ),
+	particlesMin( particlesMaxArg ),
+	particlesEffective( particlesMaxArg ),
+	normalized( false ),
+	neff( 0.0f ),
+	particlesMax( particlesMaxArg ),
+	particles( particlesMaxArg ),
+	particlesPadded( padded( particlesMaxArg ) ),
+	memory( nullptr ) {
+	HAWAII_ERROR_CONDITIONAL( this->particlesMax <= 0,
+	                          "Number of particles must be positive." ) ;
+	
+	// one block for current and next samples as well as weights
+	const int    capacity = padded( this->particlesMax ) ;
+	const size_t arrays   = 2 * stateDims + 1 ;
+	void* memoryRaw = nullptr ;
+	HAWAII_ERROR_CONDITIONAL( posix_memalign( &memoryRaw, 32, arrays * capacity * sizeof( float ) ) != 0,
+	                          "Could not allocate particle arrays." ) ;
+	this->memory = static_cast< float* >( memoryRaw ) ;
+	std::fill( this->memory, this->memory + arrays * capacity, 0.0f ) ;
+	for( int dim = 0 ; dim < stateDims ; ++dim ) {
+		this->samplesCurr[ dim ] = this->memory + ( 0 * stateDims + dim ) * capacity ;
+		this->samplesNext[ dim ] = this->memory + ( 1 * stateDims + dim ) * capacity ;
+	}
+	this->weightsArr = this->memory + 2 * stateDims * capacity ;
+	std::fill( this->state,          this->state          + stateDims, 0.0f ) ;
+	std::fill( this->noiseAmplitude, this->noiseAmplitude + stateDims, 0.0f ) ;
+	
+	// seed generators from a "splitmix"-like sequence, making sure no lane is stuck at zero
+	uint64_t seedLane = seed ? seed : (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count() ;
+	for( int lane = 0 ; lane < rngLanes ; ++lane ) {
+		seedLane += 0x9E3779B97F4A7C15ull ;
+		uint64_t z = seedLane ;
+		z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull ;
+		z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull ;
+		z =   z ^ ( z >> 31 ) ;
+		this->rngState[ lane ] = (uint32_t)z ? (uint32_t)z : 1u ;
+	}
+	this->resetWeights() ;
+}
+
+// d'tor to free the sample arrays
+ParticleFilter::~ParticleFilter() {
+	free( this->memory ) ;
+}
+
+// scalar draw in [0,1)
+float ParticleFilter::randomUniform() {
+	this->rngState[ 0 ] = xorshift( this->rngState[ 0 ] ) ;
+	return (float)( this->rngState[ 0 ] >> 8 ) * uint24ToUnit ;
+}
+
+// spread particles uniformly within the given bounds, reset weights, start with the maximum number of particles
+void ParticleFilter::init( const float lowerBound[ stateDims ],
+                           const float upperBound[ stateDims ] ) {
+	this->particles       = this->particlesMax ;
+	this->particlesPadded = padded( this->particles ) ;
+	for( int dim = 0 ; dim < stateDims ; ++dim ) {
+		const float range = upperBound[ dim ] - lowerBound[ dim ] ;
+		for( int particle = 0 ; particle < this->particles ; ++particle ) {
+			this->samplesCurr[ dim ][ particle ] = lowerBound[ dim ] + range * this->randomUniform() ;
+		}
+	}
+	this->resetWeights() ;
+}
+
+// set uniform process noise of given amplitudes
+void ParticleFilter::setNoise( const float noisePos,
+                               const float noiseVel,
+                               const float noiseSize,
+                               const float noiseSizeVel ) {
+	this->noiseAmplitude[ posX  ] = noisePos ;
+	this->noiseAmplitude[ posY  ] = noisePos ;
+	this->noiseAmplitude[ sizeH ] = noiseSize ;
+	this->noiseAmplitude[ velX  ] = noiseVel ;
+	this->noiseAmplitude[ velY  ] = noiseVel ;
+	this->noiseAmplitude[ velH  ] = noiseSizeVel ;
+}
+
+// enable adaptive particle count
+void ParticleFilter::setAdaptive( const int particlesMinArg,
+                                  const int particlesEffectiveArg ) {
+	HAWAII_ERROR_CONDITIONAL( particlesMinArg <= 0 || particlesMinArg > this->particlesMax,
+	                          "Minimum number of particles must be positive and not exceed the maximum." ) ;
+	HAWAII_ERROR_CONDITIONAL( particlesEffectiveArg <= 0,
+	                          "Number of effective particles must be positive." ) ;
+	this->adaptive           = true ;
+	this->particlesMin       = particlesMinArg ;
+	this->particlesEffective = particlesEffectiveArg ;
+}
+
+// number of particles to draw in the next resampling step
+int ParticleFilter::countNext() const {
+	if( !this->adaptive ) {
+		return this->particles ;
+	}
+	if( !this->normalized ) {
+		return this->particlesMax ;
+	}
+	const float required = std::ceil( this->particlesEffective / std::max( this->neff, 1.0f / this->particlesMax ) ) ;
+	const int   count    = ( required < this->particlesMax ) ? (int)required : this->particlesMax ;
+	return std::max( std::max( count, this->particles / 2 ), this->particlesMin ) ;
+}
+
+// reset weights to neutral, padding particles to zero
+void ParticleFilter::resetWeights() {
+	std::fill( this->weightsArr,                   this->weightsArr + this->particles,       1.0f ) ;
+	std::fill( this->weightsArr + this->particles, this->weightsArr + this->particlesPadded, 0.0f ) ;
+}
+
+// normalize weights to a sum of one and return the normalized effective sample size
+float ParticleFilter::normalize() {
+	
+	// sum weights, padding must not contribute
+	std::fill( this->weightsArr + this->particles, this->weightsArr + this->particlesPadded, 0.0f ) ;
+	Vec sumV = vSet( 0.0f ) ;
+	for( int particle = 0 ; particle < this->particlesPadded ; particle += lanes ) {
+		sumV = vAdd( sumV, vLoad( this->weightsArr + particle ) ) ;
+	}
+	const float sum = vSum( sumV ) ;
+	
+	// no particle near any measurement: fall back to neutral weights
+	if( !( sum > 0.0f ) || std::isinf( sum ) ) {
+		std::fill( this->weightsArr, this->weightsArr + this->particles, 1.0f / this->particles ) ;
+		this->neff       = 1.0f ;
+		this->normalized = true ;
+		return this->neff ;
+	}
+	
+	// scale and accumulate squares in the same pass
+	const Vec scaleV = vSet( 1.0f / sum ) ;
+	Vec sumSquaresV = vSet( 0.0f ) ;
+	for( int particle = 0 ; particle < this->particlesPadded ; particle += lanes ) {
+		const Vec weightV = vMul( vLoad( this->weightsArr + particle ), scaleV ) ;
+		vStore( this->weightsArr + particle, weightV ) ;
+		sumSquaresV = vAdd( sumSquaresV, vMul( weightV, weightV ) ) ;
+	}
+	this->neff       = 1.0f / ( vSum( sumSquaresV ) * this->particles ) ;
+	this->normalized = true ;
+	return this->neff ;
+}
+
+// weighted mean estimate of all state dimensions in one pass
+// user note: The estimate is "NAN" if all weights are zero, same as "CvConDensation::State".
+void ParticleFilter::estimate() {
+	Vec sumWeightsV = vSet( 0.0f ),
+	    sumStatesV[ stateDims ] ;
+	for( int dim = 0 ; dim < stateDims ; ++dim ) {
+		sumStatesV[ dim ] = vSet( 0.0f ) ;
+	}
+	for( int particle = 0 ; particle < this->particlesPadded ; particle += lanes ) {
+		const Vec weightV = vLoad( this->weightsArr + particle ) ;
+		sumWeightsV = vAdd( sumWeightsV, weightV ) ;
+		for( int dim = 0 ; dim < stateDims ; ++dim ) {
+			sumStatesV[ dim ] = vAdd( sumStatesV[ dim ], vMul( weightV, vLoad( this->samplesCurr[ dim ] + particle ) ) ) ;
+		}
+	}
+	const float sumWeights = vSum( sumWeightsV ) ;
+	for( int dim = 0 ; dim < stateDims ; ++dim ) {
+		this->state[ dim ] = ( sumWeights > 0.0f ) ? vSum( sumStatesV[ dim ] ) / sumWeights : NAN ;
+	}
+}
+
+// systematic resampling in O(N): one random offset, then equally spaced pointers walk the cumulative weights once
+// user note: The number of particles may change here, so re-query "count()" afterwards.
+void ParticleFilter::resample( const int particlesNew ) {
+	HAWAII_ERROR_CONDITIONAL( particlesNew <= 0 || particlesNew > this->particlesMax,
+	                          "Number of particles must be positive and not exceed the maximum." ) ;
+	this->normalized = false ;
+	double sumWeights = 0.0 ;
+	for( int particle = 0 ; particle < this->particles ; ++particle ) {
+		sumWeights += this->weightsArr[ particle ] ;
+	}
+	if( !( sumWeights > 0.0 ) ) {
+		std::fill( this->weightsArr, this->weightsArr + this->particles, 1.0f ) ;
+		sumWeights = this->particles ;
+	}
+	const double step = sumWeights / particlesNew ;
+	double pointer    = step * this->randomUniform(),
+	       cumulative = this->weightsArr[ 0 ] ;
+	int    source     = 0 ;
+	for( int particle = 0 ; particle < particlesNew ; ++particle ) {
+		while( cumulative < pointer && source < this->particles - 1 ) {
+			cumulative += this->weightsArr[ ++source ] ;
+		}
+		for( int dim = 0 ; dim < stateDims ; ++dim ) {
+			this->samplesNext[ dim ][ particle ] = this->samplesCurr[ dim ][ source ] ;
+		}
+		pointer += step ;
+	}
+	std::swap( this->samplesCurr, this->samplesNext ) ;
+	this->particles       = particlesNew ;
+	this->particlesPadded = padded( particlesNew ) ;
+	this->resetWeights() ;
+}
+
+// constant velocity prediction with uniform noise
+// developer note: Heights are kept at one pixel at least, so that observation models may divide by them.
+void ParticleFilter::predict() {
+	Vec noiseScaleV[ stateDims ],
+	    noiseShiftV[ stateDims ] ;
+	for( int dim = 0 ; dim < stateDims ; ++dim ) {
+		noiseScaleV[ dim ] = vSet(  2.0f * this->noiseAmplitude[ dim ] ) ;
+		noiseShiftV[ dim ] = vSet( -1.0f * this->noiseAmplitude[ dim ] ) ;
+	}
+	float* const x  = this->samplesCurr[ posX ] ;
+	float* const y  = this->samplesCurr[ posY ] ;
+	float* const vx = this->samplesCurr[ velX ] ;
+	float* const vy = this->samplesCurr[ velY ] ;
+	float* const hh = this->samplesCurr[ sizeH ] ;
+	float* const vh = this->samplesCurr[ velH ] ;
+	const Vec heightMinV = vSet( 1.0f ) ;
+	#define NOISE( dim ) vAdd( vMul( vRandom( this->rngState ), noiseScaleV[ dim ] ), noiseShiftV[ dim ] )
+	for( int particle = 0 ; particle < this->particlesPadded ; particle += lanes ) {
+		const Vec vxV = vLoad( vx + particle ),
+		          vyV = vLoad( vy + particle ),
+		          vhV = vLoad( vh + particle ) ;
+		vStore( x  + particle, vAdd( vAdd( vLoad( x + particle ), vxV ), NOISE( posX ) ) ) ;
+		vStore( y  + particle, vAdd( vAdd( vLoad( y + particle ), vyV ), NOISE( posY ) ) ) ;
+		vStore( hh + particle, vMax( vAdd( vAdd( vLoad( hh + particle ), vhV ), NOISE( sizeH ) ), heightMinV ) ) ;
+		vStore( vx + particle, vAdd( vxV, NOISE( velX ) ) ) ;
+		vStore( vy + particle, vAdd( vyV, NOISE( velY ) ) ) ;
+		vStore( vh + particle, vAdd( vhV, NOISE( velH ) ) ) ;
+	}
+	#undef NOISE
+}
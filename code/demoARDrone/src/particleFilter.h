@@ -0,0 +1,136 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// particle filter with structure-of-arrays storage and SIMD passes
+// ================================================================
+
+#pragma once
+
+#include <cstdint>
+
+// particle filter for a box with constant velocity: The state is the 2D center position and the height of the box
+//                                                 with their rates of change. Each state dimension is stored in its own
+//                                                 contiguous, aligned array, so that prediction, normalization,
+//                                                 effective sample size and estimation each run as one vectorized pass
+//                                                 (AVX, SSE2 or scalar, depending on the compiler target).
+// user note: One "updateByTime()" call replaces "cvConDensUpdateByTime()": It computes the weighted mean estimate,
+//            resamples systematically in O(N) and predicts with constant velocity plus uniform noise. Optionally, the
+//            resampling step also adapts the number of particles, see "setAdaptive()".
+class ParticleFilter {
+	
+	// state dimensions
+	// user note: "sizeH" is the height of the box around the object in pixels, "velH" its change per image.
+	public:
+	enum StateDim {
+		posX = 0,
+		posY,
+		sizeH,
+		velX,
+		velY,
+		velH,
+		stateDims
+	} ;
+	
+	// c'tor with (maximum) number of particles and random seed, d'tor to free the sample arrays
+	// user note: A seed of zero picks a non-deterministic one.
+	public:
+	ParticleFilter( const int          particlesMaxArg,
+	                const unsigned int seed = 0 ) ;
+	~ParticleFilter() ;
+	
+	// non-copyable because of the owned sample arrays
+	private:
+	ParticleFilter(             const ParticleFilter& ) ;
+	ParticleFilter& operator =( const ParticleFilter& ) ;
+	
+	// spread particles uniformly within the given bounds, reset weights, set uniform process noise of given amplitudes
+	// user note: The height's noise amplitudes default to zero, so that it only follows its initial rate of change.
+	public:
+	void init( const float lowerBound[ stateDims ],
+	           const float upperBound[ stateDims ] ) ;
+	void setNoise( const float noisePos,
+	               const float noiseVel,
+	               const float noiseSize    = 0.0f,
+	               const float noiseSizeVel = 0.0f ) ;
+	
+	// access samples and weights
+	// user note: Write unnormalized weights for the first "count()" particles, then call "normalize()". Vectorized
+	//            observation models may instead multiply into all "countPadded()" weights, as padding ones are zero.
+	public:
+	int          count()                       const { return this->particles ; }
+	int          countPadded()                 const { return this->particlesPadded ; }
+	const float* samples( const StateDim dim ) const { return this->samplesCurr[ dim ] ; }
+	float*       weights()                             { return this->weightsArr ; }
+	
+	// weights: reset to neutral, normalize to a sum of one and return the normalized effective sample size in [0,1]
+	// user note: If all weights are zero, "normalize()" falls back to neutral ones.
+	public:
+	void  resetWeights() ;
+	float normalize() ;
+	
+	// weighted mean estimate, systematic resampling to a given number of particles, constant velocity prediction, and all
+	// of them in that order
+	public:
+	void estimate() ;
+	void resample( const int particlesNew ) ;
+	void predict() ;
+	void updateByTime() {
+		this->estimate() ;
+		this->resample( this->countNext() ) ;
+		this->predict() ;
+	}
+	
+	// adaptive particle count: Resampling draws as many particles as needed to keep "particlesEffective" effective ones
+	//                          at the latest normalized effective sample size, within "particlesMin" and the maximum.
+	//                          If the weights have not been normalized since the last update - i.e. there was no
+	//                          measurement - the count jumps back to the maximum for re-acquisition.
+	// user note: Adaptation is off until "setAdaptive()" is called. The count shrinks by at most half per update, but
+	//            may grow to the maximum at once.
+	public:
+	void setAdaptive( const int particlesMinArg,
+	                  const int particlesEffectiveArg ) ;
+	int  countNext() const ;
+	protected:
+	bool adaptive ;
+	int  particlesMin,
+	     particlesEffective ;
+	bool normalized ;
+	
+	// results
+	public:
+	float state[ stateDims ] ; // weighted mean estimate
+	float neff ;               // normalized effective sample size of the latest "normalize()"
+	
+	// sample arrays
+	// developer note: Arrays are padded to a multiple of the SIMD width. Padding particles always carry zero weight,
+	//                 which lets every pass run without a scalar remainder loop.
+	protected:
+	int    particlesMax,
+	       particles,
+	       particlesPadded ;
+	float* memory ;
+	float* samplesCurr[ stateDims ] ;
+	float* samplesNext[ stateDims ] ;
+	float* weightsArr ;
+	float  noiseAmplitude[ stateDims ] ;
+	
+	// vectorized "xorshift" random number generator, one independent state per lane
+	protected:
+	static const int rngLanes = 8 ;
+	uint32_t rngState[ rngLanes ] ;
+	float randomUniform() ; // scalar draw in [0,1)
+
+} ; // class "ParticleFilter"
@@ -0,0 +1,601 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// Author: Aakanksha Rana (rana.aakanksha@gmail.com) and Praveer Singh (praveersingh1990@gmail.com)
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// person detection (via HOG) and tracking (via particle filters)
+// ==============================================================
+
+#include "personTracker.h"
+#include "visualSink.h"
+#include "hawaii/common/error.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+// helpers only used here
+namespace {
+
+// standard hog configuration
+const cv::Size windowsz( 64, 128 ) ;
+
+} // anonymous namespace
+
+// c'tor with principal point, range of the number of particles, maximum number of tracks, recording folder and random
+// seed, set up HOG people detector, track pool and recording once
+PersonTracker::PersonTracker( const double       principalPointUArg,
+                              const int          particlesMax,
+                              const int          particlesMin,
+                              const int          tracksMax,
+                              const std::string& dumpRoot,
+                              const unsigned int seed ) :
+	
+	// camera
+	principalPointU( principalPointUArg ),
+	focalLengthNext( 0.0 ),
+	
+	// results
+	targetID( -1 ),
+	foundDot( false ),
+	offsetPix( 0.0 ),
+	neff( 0.0f ),
+	particles( 0 ),
+	timeDetection( 0.0 ),
+	stage( stageDetectFull ),
+	detected( false ),
+	detectionScore( 0.0 ),
+	similarity( 0.0f ),
+	followedID( -1 ),
+	heightEstimate( 0.0f ),
+	heightRate( 0.0f ),
+	useFeatureCache( false ),
+	
+	// re-acquisition, motion proposals are at least a HOG window plus a margin of two cells on each side
+	useMotionProposals( true ),
+	motionSearchesMax( 3 ),
+	motion( cv::Size( windowsz.width + 32, windowsz.height + 32 ) ),
+	motionSearches( 0 ),
+	
+	// HOG people detector with default SVM, either exact or via the feature cache
+	detector( cv::HOGDescriptor( windowsz, cv::Size( 16, 16 ), cv::Size( 8, 8 ), cv::Size( 8, 8 ), 9, 1, -1, 0, 0.2, true ) ),
+	featureCache( cv::HOGDescriptor::getDefaultPeopleDetector(), true ),
+	detectionsSinceFull( 0 ),
+	
+	// track management
+	hitsConfirm( 2 ),
+	missesMax( 3 ),
+	fullEvery( 5 ),
+	gateFactor( 1.0f ),
+	scaleBand( 0.3f ),
+	nextID( 0 ),
+	
+	// debug output
+	frameDump( dumpRoot ),
+	frameIndex( 0 ),
+	pause( false ) {
+	HAWAII_ERROR_CONDITIONAL( tracksMax < 1,
+	                          "Maximum number of tracks must be positive." ) ;
+	this->detector.hog.setSVMDetector( cv::HOGDescriptor::getDefaultPeopleDetector() ) ;
+	
+	// all particle filters are allocated here, "process()" only (de-)activates tracks
+	this->tracks.reserve( tracksMax ) ;
+	for( int track = 0 ; track < tracksMax ; ++track ) {
+		const unsigned int seedTrack = seed ? seed + track : 0 ; // developer note: The filter mixes the seed thoroughly.
+		this->tracks.push_back( std::unique_ptr< Track >( new Track( particlesMax, particlesMin, this->colorImage, seedTrack ) ) ) ;
+	}
+	this->tracksResult.reserve( tracksMax ) ;
+	this->searchRegions.reserve( this->motion.proposalsMax ) ;
+	this->candidates.reserve( tracksMax * 8 ) ;
+	
+	cout << "hog window size: " << windowsz.width << " " << windowsz.height << endl ;
+}
+
+// c'tor of an inactive track, detections are observed with about the spread of the blurred disc of 20 pixels radius
+// used before and a tenth of their height
+PersonTracker::Track::Track( const int                  particlesMax,
+                             const int                  particlesMin,
+                             const ColorHistogramImage& colorImage,
+                             const unsigned int         seed ) :
+	active( false ),
+	id( -1 ),
+	hits( 0 ),
+	misses( 0 ),
+	detection( -1 ),
+	particles( 0 ),
+	filter( particlesMax, seed ),
+	observation( 20.0f, 0.0f, 0.1f ),
+	appearance( colorImage, 20.0f, 0.5f ) {
+	if( particlesMin < particlesMax ) {
+		this->filter.setAdaptive( particlesMin, particlesMin ) ;
+	}
+	
+	// constant velocity dynamics with uniform process noise, the height changing much slower than the position
+	this->filter.setNoise( 25.0f, 5.0f, 4.0f, 1.0f ) ;
+}
+
+// (re-)initialize everything depending on the image size
+void PersonTracker::init( const cv::Size sizeImageArg ) {
+	
+	// search the whole image first, without any track
+	this->sizeImage           = sizeImageArg ;
+	this->searchROI           = cv::Rect( cv::Point( 0, 0 ), this->sizeImage ) ;
+	this->detectionsSinceFull = 0 ;
+	this->motionSearches      = 0 ;
+	this->followedID          = -1 ;
+	for( auto& track : this->tracks ) {
+		track->active = false ;
+		track->observation.setBounds( this->sizeImage ) ;
+	}
+	
+	// intermediate images
+	this->visualization.create( this->sizeImage, CV_8UC3 ) ;
+	this->overlay.create(       this->sizeImage, CV_8UC3 ) ;
+}
+
+// camera rotation at the time of the next image
+void PersonTracker::setRotation( const cv::Vec3d rotationGlobal,
+                                 const double    focalLength ) {
+	this->rotationNext    = rotationGlobal ;
+	this->focalLengthNext = focalLength ;
+}
+
+// HOG within a region of the image, detections moved to image coordinates
+void PersonTracker::detectIn( const cv::Mat  frame,
+                              const cv::Rect region ) {
+	const size_t first = this->found.size() ;
+	if( this->useFeatureCache ) {
+		this->featureCache.detectMultiScale( frame, region, this->foundRegion, this->foundRegionWeights, 0, cv::Size( 32, 32 ), 1.05, 2 ) ;
+	}
+	else {
+		this->detector.detectMultiScale( frame( region ), this->foundRegion, this->foundRegionWeights, 0, cv::Size( 8, 8 ), cv::Size( 32, 32 ), 1.05, 2 ) ; // Hog multiscale detection , results can substanially change with change of last two parameters.
+	}
+	this->found.insert(        this->found.end(),        this->foundRegion.begin(),        this->foundRegion.end()        ) ;
+	this->foundWeights.insert( this->foundWeights.end(), this->foundRegionWeights.begin(), this->foundRegionWeights.end() ) ;
+	this->foundWeights.resize( this->found.size(), 0.0 ) ; // developer note: Keeps both aligned should scores be missing.
+	for( size_t detection = first ; detection < this->found.size() ; ++detection ) {
+		this->found[ detection ] += region.tl() ;
+	}
+}
+
+// greedy nearest neighbor assignment of detections to the predicted positions of the tracks within the gate
+// developer note: Sorting all gated pairs by distance and taking them in order is optimal whenever persons are farther
+//                 apart than the gate, and costs O(T*D*log(T*D)) for T tracks and D detections instead of the O(n^3) of
+//                 the Hungarian method - a few microseconds for the handful of persons in view.
+void PersonTracker::associate() {
+	this->candidates.clear() ;
+	for( int track = 0 ; track < (int)this->tracks.size() ; ++track ) {
+		const Track& current = *this->tracks[ track ] ;
+		if( !current.active ) { continue ; }
+		const float gate = this->gateFactor * current.box.width ;
+		for( int detection = 0 ; detection < (int)this->foundFiltered.size() ; ++detection ) {
+			const cv::Rect&   box      = this->foundFiltered[ detection ] ;
+			const cv::Point2f center( box.x + box.width * 0.5f, box.y + box.height * 0.5f ) ;
+			const float       distance = std::hypot( center.x - current.prior.x, center.y - current.prior.y ) ;
+			if( distance <= gate ) {
+				this->candidates.push_back( std::make_pair( distance, std::make_pair( track, detection ) ) ) ;
+			}
+		}
+	}
+	std::sort( this->candidates.begin(), this->candidates.end() ) ;
+	for( const auto& candidate : this->candidates ) {
+		Track& track = *this->tracks[ candidate.second.first ] ;
+		if( track.detection >= 0 ) { continue ; }
+		bool taken = false ;
+		for( const auto& other : this->tracks ) {
+			taken = taken || ( other->active && other->detection == candidate.second.second ) ;
+		}
+		if( !taken ) { track.detection = candidate.second.second ; }
+	}
+}
+
+// start a track in a free slot of the pool, with particles spread around the detection box
+void PersonTracker::startTrack( const int detection ) {
+	for( auto& slot : this->tracks ) {
+		Track& track = *slot ;
+		if( track.active ) { continue ; }
+		const cv::Rect&   box = this->foundFiltered[ detection ] ;
+		const cv::Point2f center( box.x + box.width * 0.5f, box.y + box.height * 0.5f ) ;
+		const float lowerBound[ ParticleFilter::stateDims ] = { center.x - box.width * 0.25f, center.y - box.height * 0.25f, box.height * 0.9f, -2.0f, -2.0f, -1.0f },
+		            upperBound[ ParticleFilter::stateDims ] = { center.x + box.width * 0.25f, center.y + box.height * 0.25f, box.height * 1.1f,  2.0f,  2.0f,  1.0f } ;
+		track.filter.init( lowerBound, upperBound ) ;
+		track.appearance.reset() ;
+		track.boxSmoother.clear() ;
+		track.active    = true ;
+		track.id        = this->nextID++ ;
+		track.hits      = 0 ;
+		track.misses    = 0 ;
+		track.box       = box ;
+		track.detection = detection ;
+		track.prior       = center ;
+		track.priorHeight = (float)box.height ;
+		return ;
+	}
+}
+
+// weigh a track's particles by its assigned detection and its appearance, estimate, resample, predict
+void PersonTracker::updateTrack( Track& track ) {
+	
+	// update phase: weigh particles by the Gaussian around the assigned detection and by their appearance, normalize
+	// developer note: Weights are neutral before, so they are exactly the likelihoods when drawn here.
+	track.filter.resetWeights() ;
+	track.observation.clear() ;
+	bool measured = false ;
+	if( track.detection >= 0 ) {
+		track.box = this->foundFiltered[ track.detection ] ;
+		track.boxSmoother.push( track.box ) ;
+		track.observation.add( cv::Point2f( track.box.x + track.box.width * 0.5f, track.box.y + track.box.height * 0.5f ),
+		                       1.0f, (float)track.box.height ) ;
+		track.observation.weigh( track.filter ) ;
+		++track.hits ;
+		track.misses = 0 ;
+		measured = true ;
+	}
+	if( track.appearance.learned() ) {
+		track.appearance.weigh( track.filter ) ;
+		measured = true ;
+	}
+	if( measured ) {
+		const float* const weights  = track.filter.weights() ;
+		const float* const samplesX = track.filter.samples( ParticleFilter::posX ),
+		           * const samplesY = track.filter.samples( ParticleFilter::posY ) ;
+		for( int particle = 0 ; particle < track.filter.count() ; ++particle ) {
+			if( weights[ particle ] > 0.0f ) {
+				cv::circle( this->overlay, cv::Point( (int)samplesX[ particle ], (int)samplesY[ particle ] ), 2,
+				            CV_RGB( weights[ particle ] * 200, weights[ particle ] * 2000000, 255 ), -1, 8, 0 ) ;
+			}
+		}
+		track.filter.normalize() ;
+	}
+	
+	// learn the appearance from the central part of the detection window that the person fills
+	if( track.detection >= 0 ) {
+		track.appearance.learn( cv::Rect( track.box.x + track.box.width / 4, track.box.y + track.box.height / 8,
+		                                  track.box.width / 2, track.box.height * 3 / 4 ) ) ;
+	}
+	
+	// estimate, resample (adapting the number of particles), predict
+	// developer note: Without any measurement, weights are still neutral from the previous resampling, so resampling
+	//                 again would only add noise - and would make the filter grow back to the maximum count as if the
+	//                 person had been lost.
+	track.particles = track.filter.count() ;
+	if( this->stage != stagePredict || measured ) {
+		track.filter.updateByTime() ;
+	}
+	else {
+		track.filter.estimate() ;
+		track.filter.predict() ;
+	}
+}
+
+// narrow the HOG pyramid to the predicted heights of the tracks within the search ROI when searching there
+// developer note: A detection of window height 128 at level scale s is 128 * s pixels high, so the band of heights maps
+//                 directly to a band of level scales. Level scales below one do not exist, i.e. closer persons are
+//                 searched at the finest level anyway.
+void PersonTracker::limitScales() {
+	double levelScaleMin = 1.0,
+	       levelScaleMax = HUGE_VAL ;
+	if( this->stage == stageDetectROI && this->scaleBand > 0.0f ) {
+		float heightMin = HUGE_VALF,
+		      heightMax = 0.0f ;
+		for( const auto& track : this->tracks ) {
+			if( !track->active || !std::isfinite( track->priorHeight ) ) { continue ; }
+			if( !this->searchROI.contains( cv::Point( cvRound( track->prior.x ), cvRound( track->prior.y ) ) ) ) { continue ; }
+			heightMin = std::min( heightMin, track->priorHeight ) ;
+			heightMax = std::max( heightMax, track->priorHeight ) ;
+		}
+		if( heightMax > 0.0f ) {
+			levelScaleMin = heightMin * ( 1.0f - this->scaleBand ) / windowsz.height ;
+			levelScaleMax = heightMax * ( 1.0f + this->scaleBand ) / windowsz.height ;
+		}
+	}
+	this->detector.levelScaleMin     = levelScaleMin ;
+	this->detector.levelScaleMax     = levelScaleMax ;
+	this->featureCache.levelScaleMin = levelScaleMin ;
+	this->featureCache.levelScaleMax = levelScaleMax ;
+}
+
+// the track selected by the user if alive, otherwise keep the followed one or take the most detected confirmed one
+void PersonTracker::selectTarget() {
+	const Track* followed = NULL ;
+	const Track* best     = NULL ;
+	for( const auto& track : this->tracks ) {
+		if( !track->active ) { continue ; }
+		if( track->id == ( this->targetID >= 0 ? this->targetID : this->followedID ) ) {
+			followed = track.get() ;
+		}
+		if( track->hits >= this->hitsConfirm && ( best == NULL || track->hits > best->hits ) ) {
+			best = track.get() ;
+		}
+	}
+	if( followed == NULL && this->targetID < 0 ) {
+		followed = best ;
+	}
+	this->followedID = followed != NULL ? followed->id : -1 ;
+}
+
+// detect and track persons in the latest front camera image, or only propagate the tracks
+bool PersonTracker::process( const cv::Mat frame,
+                             const bool    detect ) {
+	
+	// check input
+	HAWAII_ERROR_CONDITIONAL( frame.empty(),
+	                          "Image must not be empty." ) ;
+	HAWAII_ERROR_CONDITIONAL( frame.type() != CV_8UC3,
+	                          "Image type must be \"CV_8UC3\"." ) ;
+	
+	// (re-)initialize on the first image or whenever the image size changes
+	if( frame.size() != this->sizeImage ) {
+		this->init( frame.size() ) ;
+	}
+	const int w = this->sizeImage.width,
+	          h = this->sizeImage.height ;
+	const cv::Rect imageRect( 0, 0, w, h ) ;
+	
+	// reset results, keep the score of the latest detection when only predicting
+	this->foundDot       = false ;
+	this->offsetPix      = 0.0 ;
+	if( detect ) {
+		this->detected       = false ;
+		this->detectionScore = 0.0 ;
+	}
+	
+	// ego-motion compensated frame differences need every image, with the rotation set for it if any
+	this->motion.setImage( frame ) ;
+	if( this->focalLengthNext > 0.0 ) {
+		this->motion.setRotation( this->rotationNext, this->focalLengthNext ) ;
+		this->focalLengthNext = 0.0 ;
+	}
+	
+	// search the region around the tracks, or instead of the whole image only where something moved if possible
+	this->stage = !detect                      ? stagePredict    :
+	              this->searchROI == imageRect ? stageDetectFull :
+	                                             stageDetectROI  ;
+	this->searchRegions.clear() ;
+	if( this->stage == stageDetectFull && this->useMotionProposals && this->motionSearches < this->motionSearchesMax ) {
+		const std::vector< cv::Rect >& proposals = this->motion.propose() ;
+		if( !proposals.empty() ) {
+			this->stage = stageDetectMotion ;
+			this->searchRegions.assign( proposals.begin(), proposals.end() ) ;
+		}
+	}
+	if( this->stage == stageDetectFull   ) { this->searchRegions.push_back( imageRect ) ; this->motionSearches = 0 ; }
+	if( this->stage == stageDetectMotion ) { ++this->motionSearches ; }
+	if( this->stage == stageDetectROI    ) { this->searchRegions.push_back( this->searchROI ) ; ++this->detectionsSinceFull ; }
+	if( this->stage == stageDetectFull || this->stage == stageDetectMotion ) { this->detectionsSinceFull = 0 ; }
+	
+	// the input itself gets detections and search ROI drawn onto, its copy additionally gets particles
+	cv::Mat temp1 = frame ;
+	frame.copyTo( this->visualization ) ;
+	this->overlay.setTo( cv::Scalar::all( 0 ) ) ;
+	
+	// integral color histogram, needed whenever an appearance is used or may be learned
+	bool appearanceUsed = detect ;
+	for( const auto& track : this->tracks ) {
+		appearanceUsed = appearanceUsed || ( track->active && track->appearance.learned() ) ;
+	}
+	if( appearanceUsed ) {
+		this->colorImage.setImage( frame ) ;
+	}
+	
+	// predicted positions and heights of all tracks as priors for the HOG scales and the association
+	for( auto& track : this->tracks ) {
+		track->detection = -1 ;
+		if( !track->active ) { continue ; }
+		track->filter.estimate() ;
+		track->prior       = cv::Point2f( track->filter.state[ ParticleFilter::posX ], track->filter.state[ ParticleFilter::posY ] ) ;
+		track->priorHeight = track->filter.state[ ParticleFilter::sizeH ] ;
+	}
+	
+	// measurement (hog detection), skipped when only predicting
+	this->timeDetection = 0.0 ;
+	if( detect ) {
+		this->found.clear() ;
+		this->foundWeights.clear() ;
+		this->foundFiltered.clear() ;
+		this->foundFilteredWeights.clear() ;
+		this->limitScales() ;
+		this->timeDetection = (double)cv::getTickCount() ;
+		this->featureCache.beginFrame() ;
+		for( const auto& region : this->searchRegions ) {
+			this->detectIn( frame, region ) ;
+		}
+		this->timeDetection = ( (double)cv::getTickCount() - this->timeDetection ) * 1000.0 / cv::getTickFrequency() ;
+		
+		// filter hog detections contained in others
+		size_t i, j;
+		for( i = 0; i < this->found.size(); i++ )
+		{
+			cv::Rect r = this->found[i];
+			for( j = 0; j < this->found.size(); j++ )
+				if( j != i && (r & this->found[j]) == r)
+					break;
+			if( j == this->found.size() ) {
+				this->foundFiltered.push_back(r);
+				this->foundFilteredWeights.push_back( i < this->foundWeights.size() ? this->foundWeights[i] : 0.0 );
+				cv::rectangle(temp1,r.tl(),r.br(),cv::Scalar(0,0,255),2);
+				cout << "detection: " << r.x << " "<< r.y<<endl;
+			}
+		}
+		
+		// motion proposals in magenta
+		if( this->stage == stageDetectMotion ) {
+			for( const auto& region : this->searchRegions ) {
+				cv::rectangle( temp1,         region.tl(), region.br(), cv::Scalar( 255, 0, 255 ), 1 ) ;
+				cv::rectangle( this->overlay, region.tl(), region.br(), cv::Scalar( 255, 0, 255 ), 1 ) ;
+			}
+		}
+	}
+	
+	// assign detections, end tracks that HOG should have seen but missed repeatedly or that left the image, start tracks
+	// for the remaining detections as long as the pool has room
+	if( detect ) {
+		this->associate() ;
+		for( auto& track : this->tracks ) {
+			if( !track->active || track->detection >= 0 ) { continue ; }
+			const cv::Point prior( cvRound( track->prior.x ), cvRound( track->prior.y ) ) ;
+			for( const auto& region : this->searchRegions ) {
+				if( region.contains( prior ) ) { ++track->misses ; break ; }
+			}
+			track->active = track->misses < this->missesMax && imageRect.contains( prior ) ;
+		}
+		for( int detection = 0 ; detection < (int)this->foundFiltered.size() ; ++detection ) {
+			bool assigned = false ;
+			for( const auto& track : this->tracks ) {
+				assigned = assigned || ( track->active && track->detection == detection ) ;
+			}
+			if( !assigned ) { this->startTrack( detection ) ; }
+		}
+	}
+	else {
+		for( auto& track : this->tracks ) {
+			if( !track->active ) { continue ; }
+			track->active = imageRect.contains( cv::Point( cvRound( track->prior.x ), cvRound( track->prior.y ) ) ) ;
+		}
+	}
+	
+	// update all tracks and choose the one to follow
+	for( auto& track : this->tracks ) {
+		if( track->active ) { this->updateTrack( *track ) ; }
+	}
+	this->selectTarget() ;
+	
+	// results w.r.t. the followed track
+	const Track* followed = NULL ;
+	for( const auto& track : this->tracks ) {
+		if( track->active && track->id == this->followedID ) { followed = track.get() ; }
+	}
+	if( followed != NULL ) {
+		const float dotXcordinate = followed->filter.state[ ParticleFilter::posX ] ;
+		this->estimate   = cv::Point( (int)followed->filter.state[ ParticleFilter::posX ], (int)followed->filter.state[ ParticleFilter::posY ] ) ;
+		this->neff       = followed->filter.neff ;
+		this->particles  = followed->particles ;
+		this->similarity = followed->appearance.similarity( cv::Point2f( followed->filter.state[ ParticleFilter::posX ],
+		                                                                 followed->filter.state[ ParticleFilter::posY ] ),
+		                                                    followed->filter.state[ ParticleFilter::sizeH ] ) ;
+		this->heightEstimate = followed->filter.state[ ParticleFilter::sizeH ] ;
+		this->heightRate     = followed->filter.state[ ParticleFilter::velH  ] ;
+		this->offsetPix  = (dotXcordinate/0.5) - this->principalPointU; //difference in the x coordinate of the dot and the principal point
+		if (!(std:: isnan(dotXcordinate))) //if the tracker dot is visible in the window
+		{
+			this->foundDot = true;
+		}
+		
+		// Averaging of the detected box over past 20 frames
+		if( followed->detection >= 0 ) {
+			this->detected       = true ;
+			this->detectionScore = this->foundFilteredWeights[ followed->detection ] ;
+			// developer note: The raw box is used until the smoother is full, as with the queues used before.
+			const cv::Rect smoothed = followed->boxSmoother.full() ? followed->boxSmoother.weightedMean() : followed->box ;
+			cv::rectangle(this->overlay,smoothed.tl(),smoothed.br(),cv::Scalar(0,0,255),2);// Hog detection
+		}
+	}
+	else {
+		this->estimate       = cv::Point( -1, -1 ) ;
+		this->neff           = 0.0f ;
+		this->particles      = 0 ;
+		this->similarity     = 0.0f ;
+		this->heightEstimate = 0.0f ;
+		this->heightRate     = 0.0f ;
+	}
+	
+	// results w.r.t. all tracks, drawn with their IDs, the followed one highlighted
+	this->tracksResult.clear() ;
+	for( const auto& track : this->tracks ) {
+		if( !track->active ) { continue ; }
+		TrackResult result ;
+		result.id        = track->id ;
+		result.confirmed = track->hits >= this->hitsConfirm ;
+		result.estimate  = cv::Point( (int)track->filter.state[ ParticleFilter::posX ], (int)track->filter.state[ ParticleFilter::posY ] ) ;
+		result.box       = track->box ;
+		this->tracksResult.push_back( result ) ;
+		ostringstream label ;
+		label << track->id ;
+		const cv::Scalar color = track->id == this->followedID ? cv::Scalar( 0, 255, 255 ) :
+		                         result.confirmed                ? cv::Scalar( 0, 255,   0 ) :
+		                                                           cv::Scalar( 128, 128, 128 ) ;
+		cv::circle( this->visualization, result.estimate, 10, color, 2 ) ;
+		cv::circle( temp1,               result.estimate, 10, color, 2 ) ;
+		cv::putText( this->visualization, label.str(), result.estimate + cv::Point( 12, -12 ), cv::FONT_HERSHEY_SIMPLEX, 0.5, color ) ;
+		cv::putText( temp1,               label.str(), result.estimate + cv::Point( 12, -12 ), cv::FONT_HERSHEY_SIMPLEX, 0.5, color ) ;
+		cout << "Track " << track->id << ( track->id == this->followedID ? " (followed)" : "" )
+		     << ": position " << result.estimate.x << " " << result.estimate.y << ", hits " << track->hits
+		     << ", height " << track->filter.state[ ParticleFilter::sizeH ] << ", particles " << track->particles
+		     << ", neff " << track->filter.neff << endl ;
+	}
+	cout << "Particles: " << this->particles << ", neff: " << this->neff << ", similarity: " << this->similarity << endl ;
+	
+	// ROI is the yellow region of interest: twice the box around each track, the whole image without tracks, after a
+	// HOG run found nothing, or regularly to find new persons
+	const bool searchFull = this->tracksResult.empty()
+	                     || ( detect && this->foundFiltered.empty() )
+	                     || this->detectionsSinceFull + 1 >= this->fullEvery ;
+	if( searchFull ) {
+		this->searchROI = imageRect ;
+	}
+	else {
+		cv::Rect roi ;
+		for( const auto& result : this->tracksResult ) {
+			const cv::Rect around( result.estimate.x - result.box.width, result.estimate.y - result.box.height,
+			                       result.box.width * 2, result.box.height * 2 ) ;
+			roi = roi.area() > 0 ? ( roi | around ) : around ;
+		}
+		this->searchROI = roi & imageRect ;
+		if( this->searchROI.area() == 0 ) { this->searchROI = imageRect ; }
+	}
+	cout << "Search roi: "<<this->searchROI.x << " "<<this->searchROI.y << " "<<this->searchROI.width << " " << this->searchROI.height<<endl;
+	
+	cv::rectangle(this->overlay,this->searchROI.tl(),this->searchROI.br(),cv::Scalar(0,255,255),1);
+	cv::rectangle(temp1,this->searchROI.tl(),this->searchROI.br(),cv::Scalar(0,255,255),1);
+	
+	cv::scaleAdd(this->overlay,0.95,this->visualization,this->visualization);
+	
+	// record without blocking, the writer thread drops frames rather than delaying the commands
+	if( this->frameDump.enabled() ) {
+		ostringstream convert;
+		convert << this->frameIndex;
+		this->frameDump.pushImage( "image_withoutP/"+convert.str()+".jpg", temp1 ) ;
+		this->frameDump.pushImage( "image_particles/"+convert.str()+".jpg", this->visualization ) ;
+		this->frameDump.pushVideo( "out.mov", this->visualization, 15 ) ;
+		cout << "Frames recorded: " << this->frameDump.written() << ", dropped: " << this->frameDump.dropped()
+		     << ", failed: " << this->frameDump.failed() << endl ;
+	}
+	this->frameIndex ++;
+	
+	// show without blocking, keys arrive via the visualization thread
+	// developer note: Tracking used to block for 200 ms here in "cv::waitKey()", capping it at 5 Hz.
+	VisualSink::instance().show( "main",              this->visualization ) ;
+	VisualSink::instance().show( "without_particles", temp1               ) ;
+	const char c = (char)( this->pause ? VisualSink::instance().waitKey( 0 ) : VisualSink::instance().pollKey() ) ;
+	
+	if( c == ' ')
+		this->pause=!this->pause;
+	if(c == 'r')
+	{
+		this->searchROI = imageRect ;
+	}
+	if( c >= '0' && c <= '9' ) {
+		this->targetID = c - '0' ;
+	}
+	if( c == 'a' ) {
+		this->targetID = -1 ;
+	}
+	
+	return true;
+}
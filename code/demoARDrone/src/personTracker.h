@@ -0,0 +1,220 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// Author: Aakanksha Rana (rana.aakanksha@gmail.com) and Praveer Singh (praveersingh1990@gmail.com)
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// person detection (via HOG) and tracking (via particle filters)
+// ==============================================================
+
+#pragma once
+
+#include "frameDump.h"
+#include "hogFeatureCache.h"
+#include "motionProposals.h"
+#include "observationModel.h"
+#include "parallelHOG.h"
+#include "particleFilter.h"
+#include "ringBuffer.h"
+#include <opencv2/core/core.hpp>
+#include <opencv2/objdetect/objdetect.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// stateful detector and multi-person tracker: Everything expensive to set up - the HOG descriptor with its people SVM,
+//                                             a pool of particle filters, the video writer and all intermediate images
+//                                             - is created once and reused, so that tracks persist between frames and
+//                                             "process()" does not allocate once the image size has settled.
+// user note: Each person gets a track with its own compact particle filter and color appearance. Detections are
+//            assigned to tracks greedily by distance within a gate, unassigned ones start new tracks and tracks die
+//            after missing several detections they should have had. Results refer to the single followed track.
+class PersonTracker {
+	
+	// c'tor with the principal point of the image passed to "process()", the range of the number of particles per track,
+	// the maximum number of tracks and the folder to record debug images and video into
+	// user note: "appFollowPersonFP" passes images downscaled by 0.5, but the principal point of the full image.
+	// user note: Recording runs on its own thread (see "FrameDump"), an empty folder disables it.
+	// user note: While a track is confident, its particle set shrinks until about "particlesMin" of them are effective.
+	//            It grows back toward "particlesMax" when the effective sample size collapses or detection is lost. Pass
+	//            identical values to use a fixed number of particles.
+	// user note: A non-zero "seed" makes the particle filters reproducible, e.g. for benchmarks, zero picks one at random.
+	public:
+	PersonTracker( const double       principalPointU,
+	               const int          particlesMax = 2000,
+	               const int          particlesMin =  250,
+	               const int          tracksMax    =    4,
+	               const std::string& dumpRoot     = "/home/drone/repos",
+	               const unsigned int seed         =    0 ) ;
+	protected:
+	double principalPointU ;
+	
+	// detect and track persons in the latest front camera image, or - if "detect" is "false" - only track them via
+	// their color appearance and keep the distance measured by the latest detection
+	// user note: The results below are only valid after "process()" has returned "true".
+	public:
+	bool process( const cv::Mat frame,
+	              const bool    detect = true ) ;
+	
+	// camera rotation at the time of the next image passed to "process()", as on-board odometry's pitch, yaw and roll
+	// with the focal length of that image in pixels
+	// user note: Optional, motion proposals fall back to image registration for images without it.
+	public:
+	void setRotation( const cv::Vec3d rotationGlobal,
+	                  const double    focalLength ) ;
+	protected:
+	cv::Vec3d rotationNext ;
+	double    focalLengthNext ;
+	
+	// what "process()" did with the latest image
+	public:
+	enum Stage {
+		stageDetectFull,   // HOG on the whole image
+		stageDetectMotion, // HOG within regions of ego-motion compensated frame differences
+		stageDetectROI,    // HOG within the search region around the tracks
+		stagePredict       // no HOG, color appearance and particle filter prediction only
+	} ;
+	
+	// which track to follow: a track ID, or -1 to keep following the current one and - once it dies - pick the confirmed
+	// track with the most detections
+	// user note: Keys "0" to "9" in the visualization window select the track of that ID, "a" switches back to -1.
+	public:
+	int targetID ;
+	
+	// results of the latest call to "process()" w.r.t. the followed track
+	public:
+	bool      foundDot       ; // tracker estimate is valid
+	double    offsetPix      ; // horizontal offset of the estimate w.r.t. the principal point in pixels
+	cv::Point estimate       ; // estimated person position
+	float     neff           ; // normalized effective sample size of the particle set in [0,1]
+	int       particles      ; // number of particles used for the latest image
+	double    timeDetection  ; // duration of the HOG detection in milliseconds
+	Stage     stage          ; // what was done with the latest image
+	bool      detected       ; // whether the latest HOG run found the person
+	double    detectionScore ; // SVM score of the person's detection in the latest HOG run
+	float     similarity     ; // Bhattacharyya coefficient of the appearance at the estimate, zero until learned
+	int       followedID     ; // ID of the followed track, -1 if none
+	float     heightEstimate ; // tracked height of the person's detection box in pixels, zero if none
+	float     heightRate     ; // change of that height per image in pixels
+	
+	// results of the latest call to "process()" w.r.t. all tracks
+	public:
+	struct TrackResult {
+		int       id ;
+		bool      confirmed ; // detected often enough to be followed automatically
+		cv::Point estimate ;
+		cv::Rect  box ;       // latest assigned detection
+	} ;
+	std::vector< TrackResult > tracksResult ;
+	
+	// alternative HOG path re-using gradients of unchanged cells across frames and sharing them between pyramid levels
+	// user note: Off by default, as its scores only approximate those of "cv::HOGDescriptor" (see "HOGFeatureCache").
+	public:
+	bool useFeatureCache ;
+	
+	// re-acquisition via motion proposals: Instead of searching the whole image, HOG only searches the few regions where
+	//                                      something moved relative to the compensated motion of the drone itself
+	// user note: After "motionSearchesMax" consecutive searches within motion proposals, or if there are none, the whole
+	//            image is searched again, so that persons standing still are found as well.
+	public:
+	bool useMotionProposals ;
+	int  motionSearchesMax ;
+	protected:
+	MotionProposals motion ;
+	int             motionSearches ; // consecutive searches within motion proposals
+	
+	// (re-)initialize everything depending on the image size
+	protected:
+	void init( const cv::Size sizeImageArg ) ;
+	cv::Size sizeImage ;
+	
+	// HOG people detector (parallelized across cores), search region of interest, regions actually searched in the
+	// latest image, detections of the latest image in image coordinates with their SVM scores
+	protected:
+	void detectIn( const cv::Mat frame, const cv::Rect region ) ; // appends to "found" and "foundWeights"
+	ParallelHOG             detector             ;
+	HOGFeatureCache         featureCache         ;
+	cv::Rect                searchROI            ;
+	std::vector< cv::Rect > searchRegions        ;
+	int                     detectionsSinceFull  ; // HOG runs within a search ROI since the last one on the whole image
+	std::vector< cv::Rect > found                ,
+	                        foundRegion          , // of a single region, relative to it
+	                        foundFiltered        ;
+	std::vector< double >   foundWeights         ,
+	                        foundRegionWeights   ,
+	                        foundFilteredWeights ;
+	
+	// track: state of box center and height with their rates of change, constant velocity dynamics and uniform noise,
+	// observed through a Gaussian around its assigned detection and - on every image - through the color histogram
+	// learned from its detections
+	protected:
+	struct Track {
+		Track( const int                  particlesMax,
+		       const int                  particlesMin,
+		       const ColorHistogramImage& colorImage,
+		       const unsigned int         seed ) ;
+		bool                 active ;
+		int                  id ;
+		int                  hits,          // number of assigned detections
+		                     misses ;       // number of consecutive HOG runs covering the track without detection
+		cv::Rect             box ;          // latest assigned detection
+		BoxSmoother< 20 >    boxSmoother ;  // assigned detections of the latest 20 HOG runs that found the person
+		int                  detection ;    // index of the detection assigned in the latest image, -1 if none
+		cv::Point2f          prior ;        // predicted position before the latest measurement
+		float                priorHeight ;  // predicted box height before the latest measurement
+		int                  particles ;    // number of particles used for the latest image
+		ParticleFilter       filter ;
+		DetectionObservation observation ;
+		ColorObservation     appearance ;
+	} ;
+	
+	// pool of tracks, allocated once: assign detections, start and update tracks, choose the one to follow
+	// user note: "hitsConfirm" detections confirm a track, "missesMax" consecutive misses end it, and detections farther
+	//            than "gateFactor" times a track's box width from its predicted position are never assigned to it. A
+	//            track also ends once its prediction leaves the image.
+	public:
+	int   hitsConfirm,
+	      missesMax,
+	      fullEvery ; // every how many HOG runs to search the whole image for new persons
+	float gateFactor ;
+	
+	// HOG scale range around the tracks: Within the search ROI, only pyramid levels whose window height is within
+	//                                    "scaleBand" of the predicted box heights of the tracks there are evaluated.
+	// user note: Set "scaleBand" to zero to always evaluate all levels. Searches for new persons always do.
+	public:
+	float scaleBand ;
+	protected:
+	void limitScales() ;
+	protected:
+	void associate() ;
+	void startTrack( const int detection ) ;
+	void updateTrack( Track& track ) ;
+	void selectTarget() ;
+	ColorHistogramImage                                      colorImage ; // shared by the appearance models of all tracks
+	std::vector< std::unique_ptr< Track > >                  tracks ;
+	int                                                      nextID ;
+	std::vector< std::pair< float, std::pair< int, int > > > candidates ; // (distance, (track, detection))
+	
+	// visualization and debug output
+	protected:
+	cv::Mat   visualization, // copy of the input with particles, detections and search ROI
+	          overlay       ; // particles and detections to be blended into the copy
+	FrameDump frameDump ;
+	int       frameIndex ;
+	bool      pause ;
+
+} ; // class "PersonTracker"
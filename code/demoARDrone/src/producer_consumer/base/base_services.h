@@ -12,6 +12,11 @@
 
 #include "cvmat_serialization.h"
 #include "concurrent_queue.h"
+#include "lockfree_queue.h"
+#include "frame_pool.h"
+#include "wire_format.h"
+#include "wire_codec.h"
+#include "stream_synchronizer.h"
 #include "message_data.h"
 
 #include "global_data.h"
@@ -0,0 +1,88 @@
+/*
+ * frame_pool.h
+ *
+ *  Reusable image buffers for MessageData frames.
+ *  A frame handed out by the pool is a cv::Mat sharing the pool's buffer by
+ *  reference count. Once every MessageData holding it is gone, only the
+ *  pool's reference is left and the buffer is handed out again, so a steady
+ *  stream of equally sized frames does not allocate at all.
+ *  Frames are immutable once they were put into a MessageData: clone()
+ *  before drawing into one.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef FRAME_POOL_H_
+#define FRAME_POOL_H_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "boost/thread/mutex.hpp"
+
+class FramePool {
+protected:
+	mutable boost::mutex mt_protectBuffers_;
+	std::vector<cv::Mat> buffers_;
+	size_t maxBuffers_;
+
+	size_t allocations_;
+	size_t copies_;
+
+	// only the pool references the buffer
+	static bool isFree(const cv::Mat& buffer) {
+		return buffer.refcount == NULL || *buffer.refcount == 1;
+	}
+public:
+	explicit FramePool(size_t maxBuffers = 32)
+	: maxBuffers_(maxBuffers), allocations_(0), copies_(0)
+	{
+	}
+
+	// a buffer of the given shape, its content is undefined
+	cv::Mat acquire(const cv::Size& size, int type) {
+		boost::mutex::scoped_lock lock(mt_protectBuffers_);
+		std::vector<cv::Mat>::iterator reusable = buffers_.end();
+		for (std::vector<cv::Mat>::iterator it = buffers_.begin(); it != buffers_.end(); ++it) {
+			if (!isFree(*it)) continue;
+			if (it->size() == size && it->type() == type) {
+				return *it;
+			}
+			reusable = it;
+		}
+		allocations_++;
+		if (buffers_.size() < maxBuffers_) {
+			buffers_.push_back(cv::Mat(size, type));
+			return buffers_.back();
+		}
+		if (reusable != buffers_.end()) {
+			// the shape changed, e.g. another camera
+			*reusable = cv::Mat(size, type);
+			return *reusable;
+		}
+		// every buffer is in use: hand out one the pool does not keep
+		return cv::Mat(size, type);
+	}
+
+	// copy of an image into a pooled buffer, the single pixel copy on the way into a MessageData
+	cv::Mat copyOf(const cv::Mat& image) {
+		cv::Mat frame = acquire(image.size(), image.type());
+		image.copyTo(frame);
+		boost::mutex::scoped_lock lock(mt_protectBuffers_);
+		copies_++;
+		return frame;
+	}
+
+	// statistics since program start: buffers allocated, images copied into the pool
+	size_t allocations() const {
+		boost::mutex::scoped_lock lock(mt_protectBuffers_);
+		return allocations_;
+	}
+	size_t copies() const {
+		boost::mutex::scoped_lock lock(mt_protectBuffers_);
+		return copies_;
+	}
+};
+
+#endif /* FRAME_POOL_H_ */
@@ -7,8 +7,9 @@
 
 #include "global_data.h"
 
-concurrent_queue<MessageData> GloQueueData;
-concurrent_queue<MessageData> GloQueueCommand;
+mpsc_queue<MessageData> GloQueueData(16);
+mpsc_queue<MessageData> GloQueueCommand(64, block_when_full);
+FramePool GloFramePool;
 
 std::string GlostrSaveSimulationFolder = "Simulation";
 
@@ -22,3 +23,14 @@ void setSystemState(SystemState state) {
 	boost::mutex::scoped_lock lock(mt_protectSystemState);
 	GloSystemState = state;
 }
+
+size_t GloNetworkThreads = 1;
+boost::mutex mt_protectNetworkThreads;
+size_t getNetworkThreads() {
+	boost::mutex::scoped_lock lock(mt_protectNetworkThreads);
+	return GloNetworkThreads;
+}
+void setNetworkThreads(size_t threads) {
+	boost::mutex::scoped_lock lock(mt_protectNetworkThreads);
+	GloNetworkThreads = threads > 0 ? threads : 1;
+}
@@ -9,14 +9,22 @@
 #include "basic_function.h"
 #include "message_data.h"
 #include "concurrent_queue.h"
+#include "lockfree_queue.h"
+#include "frame_pool.h"
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/fstream.hpp>
 
 #define TRACKING_PERFORMANCE
 
-extern concurrent_queue<MessageData> GloQueueData;
-extern concurrent_queue<MessageData> GloQueueCommand;
+//frames: pushed by the network session and the local camera callback, popped by one sender or consumer
+//the overflow policy is chosen in main() depending on the role of this laptop
+extern mpsc_queue<MessageData> GloQueueData;
+//commands: pushed by the keyboard and by every network session, from any thread of the io_service pool,
+//popped by one sender or drone, never dropped
+extern mpsc_queue<MessageData> GloQueueCommand;
+//buffers of the frames in GloQueueData
+extern FramePool GloFramePool;
 extern std::string GlostrSaveSimulationFolder;
 
 enum SystemState {
@@ -28,3 +36,7 @@ enum SystemState {
 extern SystemState getSystemState();
 extern void setSystemState(SystemState);
 
+//threads running the io_service of the network sessions, see runIoService()
+extern size_t getNetworkThreads();
+extern void setNetworkThreads(size_t);
+
@@ -0,0 +1,381 @@
+/*
+ * lockfree_queue.h
+ *
+ *  Bounded lock-free queues with the interface of concurrent_queue:
+ *  - spsc_queue: one pushing thread, one popping thread (ring buffer)
+ *  - mpsc_queue: any number of pushing threads, one popping thread
+ *    (ring buffer with a sequence number per slot, after D. Vyukov)
+ *  Elements are copied or moved into preallocated slots on push and moved
+ *  out on pop, so no node is allocated per element. Waiting threads spin
+ *  briefly and then sleep on a condition variable, which is only touched
+ *  while somebody actually sleeps.
+ *  mpsc_queue takes an overflow_policy for frame streams, see below.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef LOCKFREE_QUEUE_H_
+#define LOCKFREE_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#endif
+
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/condition_variable.hpp"
+
+namespace lockfree_detail {
+
+const size_t cache_line_size = 64;
+
+inline void cpu_relax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    _mm_pause();
+#endif
+}
+
+inline size_t round_up_power_of_two(size_t n)
+{
+    size_t p = 2;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// blocking wait for a condition that is changed without a lock
+// the notifying side only takes the mutex if a thread is (about to be) asleep
+class wait_point
+{
+private:
+    std::atomic<int> waiters_;
+    boost::mutex mutex_;
+    boost::condition_variable condition_;
+public:
+    static const int spin_count = 256;
+
+    wait_point() : waiters_(0) {}
+
+    template<typename Predicate>
+    void wait(Predicate ready)
+    {
+        for (int i = 0; i < spin_count; ++i) {
+            if (ready()) return;
+            cpu_relax();
+        }
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+        // pairs with the fence in notify(): either we see the change or the notifier sees us
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            while (!ready()) {
+                condition_.wait(lock);
+            }
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) > 0) {
+            // taking the lock orders the notification after a waiter's check of the predicate
+            boost::mutex::scoped_lock lock(mutex_);
+            condition_.notify_all();
+        }
+    }
+};
+
+template<typename Data>
+struct raw_slot
+{
+    typename std::aligned_storage<sizeof(Data), alignof(Data)>::type storage;
+    Data* get() { return reinterpret_cast<Data*>(&storage); }
+};
+
+} // namespace lockfree_detail
+
+// what mpsc_queue::push() does while the queue is full
+enum overflow_policy {
+    block_when_full,    // wait for the consumer, nothing is lost (default)
+    drop_oldest,        // discard the oldest element to make room
+    keep_latest         // like drop_oldest, and a pop discards everything but the newest element,
+                        // so the consumer always jumps to the latest frame
+};
+
+//---------------------------------------------------------------------------
+// single producer, single consumer
+// the capacity is rounded up to a power of two, push() blocks while the queue is full
+template<typename Data>
+class spsc_queue
+{
+private:
+    typedef lockfree_detail::raw_slot<Data> slot;
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::vector<slot> slots_;
+
+    // consumer side: read index and the producer's write index as last seen
+    alignas(lockfree_detail::cache_line_size) std::atomic<size_t> head_;
+    size_t tail_cached_;
+    // producer side: write index and the consumer's read index as last seen
+    alignas(lockfree_detail::cache_line_size) std::atomic<size_t> tail_;
+    size_t head_cached_;
+
+    alignas(lockfree_detail::cache_line_size) lockfree_detail::wait_point not_empty_;
+    lockfree_detail::wait_point not_full_;
+
+    spsc_queue(const spsc_queue&);
+    spsc_queue& operator=(const spsc_queue&);
+public:
+    explicit spsc_queue(size_t capacity = 64)
+    : capacity_(lockfree_detail::round_up_power_of_two(capacity)),
+      mask_(capacity_ - 1),
+      slots_(capacity_),
+      head_(0), tail_cached_(0),
+      tail_(0), head_cached_(0)
+    {
+    }
+
+    ~spsc_queue()
+    {
+        Data dropped;
+        while (try_pop(dropped)) {}
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // copies or moves the element in, depending on the argument
+    template<typename Element>
+    bool try_push(Element&& data)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cached_ == capacity_) {
+            head_cached_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cached_ == capacity_) return false;
+        }
+        new (slots_[tail & mask_].get()) Data(std::forward<Element>(data));
+        tail_.store(tail + 1, std::memory_order_release);
+        not_empty_.notify();
+        return true;
+    }
+
+    // the element is only consumed by the successful attempt
+    template<typename Element>
+    void push(Element&& data)
+    {
+        while (!try_push(std::forward<Element>(data))) {
+            not_full_.wait([this]() { return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) < capacity_; });
+        }
+    }
+
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    int size()
+    {
+        return (int)(tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire));
+    }
+
+    bool try_pop(Data& popped_value)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cached_) {
+            tail_cached_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cached_) return false;
+        }
+        Data* element = slots_[head & mask_].get();
+        popped_value = std::move(*element);
+        element->~Data();
+        head_.store(head + 1, std::memory_order_release);
+        not_full_.notify();
+        return true;
+    }
+
+    void wait_and_pop(Data& popped_value)
+    {
+        while (!try_pop(popped_value)) {
+            not_empty_.wait([this]() { return !empty(); });
+        }
+    }
+};
+
+//---------------------------------------------------------------------------
+// multiple producers, single consumer, e.g. several network sessions feeding one consumer
+// the capacity is rounded up to a power of two, see overflow_policy for a full queue
+// discarded elements are counted by dropped()
+template<typename Data>
+class mpsc_queue
+{
+private:
+    struct slot: lockfree_detail::raw_slot<Data>
+    {
+        // equals the write index once free for it, the write index + 1 once filled
+        std::atomic<size_t> sequence;
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::vector<slot> slots_;
+
+    alignas(lockfree_detail::cache_line_size) std::atomic<size_t> enqueue_pos_;
+    alignas(lockfree_detail::cache_line_size) std::atomic<size_t> dequeue_pos_;
+
+    alignas(lockfree_detail::cache_line_size) lockfree_detail::wait_point not_empty_;
+    lockfree_detail::wait_point not_full_;
+
+    std::atomic<int> policy_;
+    std::atomic<size_t> dropped_;
+
+    mpsc_queue(const mpsc_queue&);
+    mpsc_queue& operator=(const mpsc_queue&);
+
+    bool front_ready() const
+    {
+        const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return slots_[pos & mask_].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    // remove the front element, or just destroy it if popped_value is NULL
+    // the read index is claimed by CAS, because a producer dropping the oldest element competes with the consumer
+    bool dequeue(Data* popped_value)
+    {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        slot* source;
+        while (true) {
+            source = &slots_[pos & mask_];
+            const size_t sequence = source->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = (std::ptrdiff_t)sequence - (std::ptrdiff_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                return false; // empty
+            }
+            else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        Data* element = source->get();
+        if (popped_value) {
+            *popped_value = std::move(*element);
+        }
+        element->~Data();
+        source->sequence.store(pos + capacity_, std::memory_order_release);
+        not_full_.notify();
+        return true;
+    }
+public:
+    explicit mpsc_queue(size_t capacity = 64, overflow_policy policy = block_when_full)
+    : capacity_(lockfree_detail::round_up_power_of_two(capacity)),
+      mask_(capacity_ - 1),
+      slots_(capacity_),
+      enqueue_pos_(0),
+      dequeue_pos_(0),
+      policy_(policy),
+      dropped_(0)
+    {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~mpsc_queue()
+    {
+        while (dequeue(NULL)) {}
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // may be changed while the queue is in use, e.g. once the role of this process is known
+    void set_policy(overflow_policy policy) { policy_.store(policy, std::memory_order_relaxed); }
+    overflow_policy policy() const { return (overflow_policy)policy_.load(std::memory_order_relaxed); }
+
+    // number of elements discarded so far because of the policy
+    size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // copies or moves the element in, depending on the argument
+    template<typename Element>
+    bool try_push(Element&& data)
+    {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        slot* target;
+        while (true) {
+            target = &slots_[pos & mask_];
+            const size_t sequence = target->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = (std::ptrdiff_t)sequence - (std::ptrdiff_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                return false; // full: the consumer has not freed this slot yet
+            }
+            else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        new (target->get()) Data(std::forward<Element>(data));
+        target->sequence.store(pos + 1, std::memory_order_release);
+        not_empty_.notify();
+        return true;
+    }
+
+    // the element is only consumed by the successful attempt
+    template<typename Element>
+    void push(Element&& data)
+    {
+        while (!try_push(std::forward<Element>(data))) {
+            if (policy() == block_when_full) {
+                not_full_.wait([this]() { return size() < (int)capacity_; });
+            }
+            else if (dequeue(NULL)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool empty() const
+    {
+        return !front_ready();
+    }
+
+    // approximate while producers are running
+    int size()
+    {
+        const size_t dequeue = dequeue_pos_.load(std::memory_order_acquire);
+        const size_t enqueue = enqueue_pos_.load(std::memory_order_acquire);
+        return enqueue > dequeue ? (int)(enqueue - dequeue) : 0;
+    }
+
+    bool try_pop(Data& popped_value)
+    {
+        if (!dequeue(&popped_value)) {
+            return false;
+        }
+        if (policy() == keep_latest) {
+            // skip the backlog: every further element overwrites the one popped before
+            while (dequeue(&popped_value)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return true;
+    }
+
+    void wait_and_pop(Data& popped_value)
+    {
+        while (!try_pop(popped_value)) {
+            not_empty_.wait([this]() { return front_ready(); });
+        }
+    }
+};
+
+#endif /* LOCKFREE_QUEUE_H_ */
@@ -56,6 +56,8 @@ class MessageData {
 	//only need when we want to access private variables
 	//friend class boost::serialization::access;
 public:
+	//shared, immutable frame: copies of a MessageData reference the same pixels,
+	//fill it from FramePool and clone() before drawing into it
 	cv::Mat mImg;
 	Command mCommand;
 	int mLapNo;
@@ -64,18 +66,35 @@ public:
 
 	int mCommandIndex;
 
-	MessageData(const MessageData &cSource)
+	MessageData(const MessageData &cSource) = default;
+	MessageData& operator=(const MessageData &cSource) = default;
+
+	//moving hands over the frame reference without touching its reference count twice
+	MessageData(MessageData &&cSource)
+	: mImg(), mCommand(cSource.mCommand), mLapNo(cSource.mLapNo), mversion(cSource.mversion),
+	  mTimeStamp(cSource.mTimeStamp), mCommandIndex(cSource.mCommandIndex)
 	{
-		mImg = cSource.mImg.clone();
-		mCommand = cSource.mCommand;
-		mLapNo = cSource.mLapNo;
-		mTimeStamp = cSource.mTimeStamp;
-		mCommandIndex = cSource.mCommandIndex;
+		takeImage(cSource.mImg);
+	}
+
+	MessageData& operator=(MessageData &&cSource)
+	{
+		if (this != &cSource) {
+			takeImage(cSource.mImg);
+			mCommand = cSource.mCommand;
+			mLapNo = cSource.mLapNo;
+			mversion = cSource.mversion;
+			mTimeStamp = cSource.mTimeStamp;
+			mCommandIndex = cSource.mCommandIndex;
+		}
+		return *this;
 	}
 
 	MessageData() {
 		mCommandIndex = -1;
 		mCommand = Command::NoCommand;
+		mLapNo = 0;
+		mversion = 0;
 	}
 
 	template <class Archive>
@@ -103,6 +122,12 @@ public:
 		return false;
 	}
 
+	//swap the Mat headers, the source is left empty
+	void takeImage(cv::Mat& source) {
+		mImg.release();
+		cv::swap(mImg, source);
+	}
+
 	static MessageData createMessage(const Command& cm) {
 		MessageData msg2;
 		msg2.mCommand = cm;
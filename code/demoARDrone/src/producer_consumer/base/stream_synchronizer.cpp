@@ -0,0 +1,109 @@
+/*
+ * stream_synchronizer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "stream_synchronizer.h"
+
+StreamSynchronizer::StreamSynchronizer(size_t streams,
+		size_t referenceStream,
+		boost::posix_time::time_duration maxSkew,
+		boost::posix_time::time_duration window,
+		size_t maxFramesPerStream)
+: streams_(streams),
+  referenceStream_(referenceStream < streams ? referenceStream : 0),
+  maxSkew_(maxSkew),
+  window_(window),
+  maxFramesPerStream_(maxFramesPerStream > 0 ? maxFramesPerStream : 1),
+  matched_(0),
+  unmatched_(0),
+  dropped_(0)
+{
+}
+
+StreamSynchronizer::Stream::iterator StreamSynchronizer::nearest(Stream& stream, const boost::posix_time::ptime& time) {
+	Stream::iterator after = stream.lower_bound(time);
+	if (after == stream.begin()) {
+		return after;
+	}
+	Stream::iterator before = after;
+	--before;
+	if (after == stream.end() || time - before->first <= after->first - time) {
+		return before;
+	}
+	return after;
+}
+
+void StreamSynchronizer::eraseUpTo(Stream& stream, Stream::iterator last, bool lastMatched) {
+	for (Stream::iterator it = stream.begin(); it != last; ) {
+		stream.erase(it++);
+		unmatched_++;
+	}
+	stream.erase(last);
+	if (!lastMatched) {
+		unmatched_++;
+	}
+}
+
+bool StreamSynchronizer::add(size_t stream, const MessageData& msg) {
+	if (stream >= streams_.size()) {
+		return false;
+	}
+	if (msg.mTimeStamp.is_special()) {
+		dropped_++;
+		return true;
+	}
+	Stream& frames = streams_[stream];
+	if (frames.count(msg.mTimeStamp) > 0) {
+		dropped_++;
+	}
+	frames[msg.mTimeStamp] = msg;
+
+	const boost::posix_time::ptime oldest = frames.rbegin()->first - window_;
+	while (frames.begin()->first < oldest || frames.size() > maxFramesPerStream_) {
+		frames.erase(frames.begin());
+		dropped_++;
+	}
+	return true;
+}
+
+bool StreamSynchronizer::pop(std::vector<MessageData>& frames) {
+	Stream& reference = streams_[referenceStream_];
+	std::vector<Stream::iterator> partners(streams_.size());
+	while (!reference.empty()) {
+		const boost::posix_time::ptime time = reference.begin()->first;
+		bool complete = true;
+		bool impossible = false;
+		for (size_t i = 0; i < streams_.size() && complete && !impossible; i++) {
+			if (i == referenceStream_) continue;
+			Stream& stream = streams_[i];
+			//a closer frame may still arrive
+			if (stream.empty() || stream.rbegin()->first < time) {
+				complete = false;
+				break;
+			}
+			partners[i] = nearest(stream, time);
+			boost::posix_time::time_duration skew = partners[i]->first - time;
+			if (skew.is_negative()) skew = -skew;
+			impossible = skew > maxSkew_;
+		}
+		if (impossible) {
+			eraseUpTo(reference, reference.begin(), false);
+			continue;
+		}
+		if (!complete) {
+			return false;
+		}
+
+		frames.resize(streams_.size());
+		for (size_t i = 0; i < streams_.size(); i++) {
+			Stream::iterator match = (i == referenceStream_) ? reference.begin() : partners[i];
+			frames[i] = match->second;
+			eraseUpTo(streams_[i], match, true);
+		}
+		matched_++;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,67 @@
+/*
+ * stream_synchronizer.h
+ *
+ *  Groups frames of N streams by timestamp, one frame per stream.
+ *  Each stream keeps its frames ordered by timestamp, so the nearest frame
+ *  to a given time is found in O(log n). Frames of the reference stream,
+ *  usually the slowest one, are matched in order: a set is complete once
+ *  every other stream has a frame within maxSkew and no closer one can
+ *  still arrive, i.e. the stream already has a frame at or after the
+ *  reference time. Timestamps are assumed to increase within a stream.
+ *  Frames are MessageData handles sharing their pixels, nothing is cloned.
+ *  Not thread-safe: meant to be used by the single consumer thread.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef STREAM_SYNCHRONIZER_H_
+#define STREAM_SYNCHRONIZER_H_
+
+#include <map>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "message_data.h"
+
+class StreamSynchronizer {
+protected:
+	typedef std::map<boost::posix_time::ptime, MessageData> Stream;
+	std::vector<Stream> streams_;
+	size_t referenceStream_;
+	boost::posix_time::time_duration maxSkew_;
+	boost::posix_time::time_duration window_;
+	size_t maxFramesPerStream_;
+
+	size_t matched_;
+	size_t unmatched_;
+	size_t dropped_;
+
+	//nearest frame of a stream to a time, end() if the stream is empty
+	Stream::iterator nearest(Stream& stream, const boost::posix_time::ptime& time);
+
+	//remove frames up to and including the given one, counting them as unmatched except the last one
+	void eraseUpTo(Stream& stream, Stream::iterator last, bool lastMatched);
+public:
+	//window: frames older than this w.r.t. the newest frame of their stream are dropped
+	StreamSynchronizer(size_t streams,
+			size_t referenceStream,
+			boost::posix_time::time_duration maxSkew = boost::posix_time::milliseconds(100),
+			boost::posix_time::time_duration window = boost::posix_time::milliseconds(2500),
+			size_t maxFramesPerStream = 64);
+
+	//add a frame, return false if the stream index is out of range
+	bool add(size_t stream, const MessageData& msg);
+
+	//take the oldest complete set, frames indexed by stream
+	bool pop(std::vector<MessageData>& frames);
+
+	//statistics since construction: sets matched, frames without a partner within maxSkew,
+	//frames dropped because of the window or the size limit
+	size_t matched() const { return matched_; }
+	size_t unmatched() const { return unmatched_; }
+	size_t dropped() const { return dropped_; }
+	size_t waiting(size_t stream) const { return streams_[stream].size(); }
+};
+
+#endif /* STREAM_SYNCHRONIZER_H_ */
@@ -0,0 +1,128 @@
+/*
+ * wire_codec.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "wire_codec.h"
+
+#include <cstdlib>
+
+#include <opencv2/highgui/highgui.hpp>
+
+WireCodec GloWireCodec = WireCodec::wireCodecRaw;
+int GloWireCodecQuality = 80;
+boost::mutex mt_protectWireCodec;
+void setWireCodec(WireCodec codec, int quality) {
+	boost::mutex::scoped_lock lock(mt_protectWireCodec);
+	GloWireCodec = codec;
+	GloWireCodecQuality = std::max(1, std::min(100, quality));
+}
+WireCodec getWireCodec() {
+	boost::mutex::scoped_lock lock(mt_protectWireCodec);
+	return GloWireCodec;
+}
+int getWireCodecQuality() {
+	boost::mutex::scoped_lock lock(mt_protectWireCodec);
+	return GloWireCodecQuality;
+}
+
+bool parseWireCodec(const std::string& text, WireCodec& codec, int& quality) {
+	if (text == "raw") {
+		codec = WireCodec::wireCodecRaw;
+		return true;
+	}
+	if (text == "png") {
+		codec = WireCodec::wireCodecPNG;
+		return true;
+	}
+	if (text.compare(0, 4, "jpeg") == 0) {
+		codec = WireCodec::wireCodecJPEG;
+		if (text.size() > 5 && text[4] == ':') {
+			quality = std::atoi(text.c_str() + 5);
+		}
+		else if (text.size() != 4) {
+			return false;
+		}
+		return quality >= 1 && quality <= 100;
+	}
+	return false;
+}
+
+WireCodec acceptWireCodec(int offered) {
+	switch (offered) {
+	case WireCodec::wireCodecJPEG:
+		return WireCodec::wireCodecJPEG;
+	case WireCodec::wireCodecPNG:
+		return WireCodec::wireCodecPNG;
+	default:
+		return WireCodec::wireCodecRaw;
+	}
+}
+
+bool encodeWirePayload(const MessageData& msg, WireCodec codec, int quality, std::vector<uchar>& payload) {
+	if (msg.mImg.empty()) {
+		return false;
+	}
+	std::vector<int> params;
+	if (codec == WireCodec::wireCodecJPEG) {
+		// JPEG keeps 1 or 3 channels of 8 bits only
+		if (msg.mImg.depth() != CV_8U || (msg.mImg.channels() != 1 && msg.mImg.channels() != 3)) {
+			return false;
+		}
+		params.push_back(CV_IMWRITE_JPEG_QUALITY);
+		params.push_back(quality);
+		return cv::imencode(".jpg", msg.mImg, payload, params);
+	}
+	if (codec == WireCodec::wireCodecPNG) {
+		if (msg.mImg.depth() != CV_8U && msg.mImg.depth() != CV_16U) {
+			return false;
+		}
+		// favour speed over size, the link is faster than higher levels
+		params.push_back(CV_IMWRITE_PNG_COMPRESSION);
+		params.push_back(1);
+		return cv::imencode(".png", msg.mImg, payload, params);
+	}
+	return false;
+}
+
+bool decodeWirePayload(const WireHeader& header, const std::vector<uchar>& payload, MessageData& msg) {
+	// decodes into the pooled buffer if the shape matches, which it should
+	cv::imdecode(payload, CV_LOAD_IMAGE_UNCHANGED, &msg.mImg);
+	return msg.mImg.rows == header.rows && msg.mImg.cols == header.cols && msg.mImg.type() == header.matType;
+}
+
+bool decodeWirePayload(const WireHeader& header, const cv::Mat& payload, MessageData& msg) {
+	cv::imdecode(payload, CV_LOAD_IMAGE_UNCHANGED, &msg.mImg);
+	return msg.mImg.rows == header.rows && msg.mImg.cols == header.cols && msg.mImg.type() == header.matType;
+}
+
+//---------------------------------------------------------------------------
+
+codec_worker::codec_worker()
+: jobs_(64, block_when_full), running_(true)
+{
+	thread_ = boost::thread(&codec_worker::run, this);
+}
+
+codec_worker::~codec_worker() {
+	// the stop job runs after every job posted before
+	this->post([this]() { running_ = false; });
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+codec_worker& codec_worker::instance() {
+	static codec_worker worker;
+	return worker;
+}
+
+void codec_worker::run() {
+	boost::function<void()> job;
+	while (running_) {
+		jobs_.wait_and_pop(job);
+		job();
+		job.clear();
+	}
+}
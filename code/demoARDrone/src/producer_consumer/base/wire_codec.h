@@ -0,0 +1,118 @@
+/*
+ * wire_codec.h
+ *
+ *  Compression of the frame payload of binary messages.
+ *  The sending client offers a codec in its hello message, the receiving
+ *  session answers with the codec it accepts, raw if it does not know the
+ *  offered one. Peers of an older build never answer, so the client keeps
+ *  sending raw frames to them.
+ *  JPEG quality follows the link: wire_quality_controller lowers it while
+ *  writes take longer than a frame period or frames pile up in the writes
+ *  of the connection, and raises it again slowly. Frames skipped by the
+ *  overflow policy of GloQueueData do not count, the sender skips those
+ *  whenever the producer is faster than it polls, congested or not.
+ *  Decoding runs on codec_worker, never on an io_service thread. Encoding
+ *  runs on the sender thread calling client::asyn_sendMessage().
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef WIRE_CODEC_H_
+#define WIRE_CODEC_H_
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include "boost/thread/mutex.hpp"
+
+#include "wire_format.h"
+#include "lockfree_queue.h"
+
+//codec this laptop offers when it connects, and the highest JPEG quality
+extern void setWireCodec(WireCodec codec, int quality);
+extern WireCodec getWireCodec();
+extern int getWireCodecQuality();
+
+//parse "raw", "png", "jpeg" or "jpeg:<quality>", return false if unknown
+bool parseWireCodec(const std::string& text, WireCodec& codec, int& quality);
+
+//codec the receiver accepts for an offered one
+WireCodec acceptWireCodec(int offered);
+
+//encode msg.mImg, return false if that failed and the frame should be sent raw
+bool encodeWirePayload(const MessageData& msg, WireCodec codec, int quality, std::vector<uchar>& payload);
+
+//decode a payload into msg.mImg prepared by applyWireHeader(), return false if it does not match the header
+bool decodeWirePayload(const WireHeader& header, const std::vector<uchar>& payload, MessageData& msg);
+//same for a payload within a larger buffer, wrapped without copying as a single row of CV_8UC1
+bool decodeWirePayload(const WireHeader& header, const cv::Mat& payload, MessageData& msg);
+
+//---------------------------------------------------------------------------
+//JPEG quality per connection: multiplicative decrease under congestion, additive increase otherwise
+class wire_quality_controller {
+protected:
+	mutable boost::mutex mt_protectQuality_;
+	int quality_;
+	int qualityMin_;
+	int qualityMax_;
+	int framesGood_;
+public:
+	//a frame counts as late if writing it took longer than this
+	double writeBudgetMilliseconds;
+	//frames in a row without congestion before the quality is raised
+	int framesBeforeIncrease;
+
+	explicit wire_quality_controller(int qualityMax = 80, int qualityMin = 20)
+	: quality_(qualityMax), qualityMin_(qualityMin), qualityMax_(qualityMax), framesGood_(0),
+	  writeBudgetMilliseconds(100.0), framesBeforeIncrease(10)
+	{
+	}
+
+	void setMaximum(int qualityMax) {
+		boost::mutex::scoped_lock lock(mt_protectQuality_);
+		qualityMax_ = std::max(qualityMin_, qualityMax);
+		quality_ = std::min(quality_, qualityMax_);
+	}
+
+	int quality() const {
+		boost::mutex::scoped_lock lock(mt_protectQuality_);
+		return quality_;
+	}
+
+	//after each frame written: how long the write took, how many frame writes of the connection are still pending
+	void update(double writeMilliseconds, int writesPending) {
+		boost::mutex::scoped_lock lock(mt_protectQuality_);
+		if (writeMilliseconds > writeBudgetMilliseconds || writesPending > 0) {
+			quality_ = std::max(qualityMin_, quality_ * 3 / 4);
+			framesGood_ = 0;
+		}
+		else if (++framesGood_ >= framesBeforeIncrease) {
+			quality_ = std::min(qualityMax_, quality_ + 5);
+			framesGood_ = 0;
+		}
+	}
+};
+
+//---------------------------------------------------------------------------
+//single thread running encode/decode jobs in the order they were posted
+class codec_worker {
+protected:
+	mpsc_queue<boost::function<void()> > jobs_;
+	boost::thread thread_;
+	bool running_;
+
+	codec_worker();
+	void run();
+public:
+	~codec_worker();
+	static codec_worker& instance();
+
+	void post(const boost::function<void()>& job) {
+		jobs_.push(job);
+	}
+};
+
+#endif /* WIRE_CODEC_H_ */
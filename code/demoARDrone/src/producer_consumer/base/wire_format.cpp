@@ -0,0 +1,143 @@
+/*
+ * wire_format.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "wire_format.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "basic_function.h"
+
+WireFormat GloWireFormat = WireFormat::wireFormatBinary;
+boost::mutex mt_protectWireFormat;
+WireFormat getWireFormat() {
+	boost::mutex::scoped_lock lock(mt_protectWireFormat);
+	return GloWireFormat;
+}
+void setWireFormat(WireFormat format) {
+	boost::mutex::scoped_lock lock(mt_protectWireFormat);
+	GloWireFormat = format;
+}
+
+static const boost::posix_time::ptime wireEpoch(boost::gregorian::date(1970, 1, 1));
+
+bool isWireHeader(const void* prefix) {
+	uint32_t magic;
+	std::memcpy(&magic, prefix, sizeof(magic));
+	return magic == WireHeader::magicNumber;
+}
+
+WireHeader makeWireHeader(const MessageData& msg) {
+	WireHeader header;
+	std::memset(&header, 0, sizeof(header));
+	header.magic = WireHeader::magicNumber;
+	header.version = WireHeader::currentVersion;
+	header.headerSize = sizeof(WireHeader);
+	header.command = (int32_t)msg.mCommand;
+	header.lapNo = msg.mLapNo;
+	header.timeStamp = msg.mTimeStamp.is_special() ? INT64_MIN : (msg.mTimeStamp - wireEpoch).total_microseconds();
+	header.commandIndex = msg.mCommandIndex;
+	header.matType = msg.mImg.type();
+	header.rows = msg.mImg.rows;
+	header.cols = msg.mImg.cols;
+	header.step = (uint64_t)msg.mImg.cols * msg.mImg.elemSize();
+	header.payloadSize = msg.mImg.empty() ? 0 : header.step * msg.mImg.rows;
+	if (header.payloadSize == 0) {
+		header.rows = header.cols = 0;
+		header.step = 0;
+	}
+	header.codec = WireCodec::wireCodecRaw;
+	header.quality = 0;
+	return header;
+}
+
+size_t wireHeaderTail(const WireHeader& header) {
+	return std::min<size_t>(header.headerSize, sizeof(WireHeader)) - wireHeaderSizeV1;
+}
+
+size_t wireHeaderExtra(const WireHeader& header) {
+	return header.headerSize > sizeof(WireHeader) ? header.headerSize - sizeof(WireHeader) : 0;
+}
+
+bool checkWireHeader(const WireHeader& header, std::string& error) {
+	const int maxDimension = 1 << 14;
+	if (header.magic != WireHeader::magicNumber) {
+		error = "no wire header";
+		return false;
+	}
+	if (header.version < 1 || header.headerSize < wireHeaderSizeV1 || header.headerSize > 4096
+			|| (header.version >= 2 && header.headerSize < sizeof(WireHeader))) {
+		error = "unsupported wire header version " + utilities::NumberToString(header.version);
+		return false;
+	}
+	if (header.command < (int32_t)Command::NoCommand || header.command > (int32_t)Command::AutoRotate) {
+		error = "unknown command " + utilities::NumberToString(header.command);
+		return false;
+	}
+	if (header.payloadSize == 0) {
+		return true;
+	}
+	if (header.rows <= 0 || header.rows > maxDimension || header.cols <= 0 || header.cols > maxDimension
+			|| CV_MAT_DEPTH(header.matType) > CV_64F || CV_MAT_CN(header.matType) > 4) {
+		error = "invalid image " + utilities::NumberToString(header.cols) + "x" + utilities::NumberToString(header.rows)
+				+ " of type " + utilities::NumberToString(header.matType);
+		return false;
+	}
+	if (header.step != (uint64_t)header.cols * CV_ELEM_SIZE(header.matType)) {
+		error = "row size does not match the image";
+		return false;
+	}
+	if (header.codec == WireCodec::wireCodecRaw && header.payloadSize != header.step * header.rows) {
+		error = "payload size does not match the image";
+		return false;
+	}
+	if (header.codec != WireCodec::wireCodecRaw && header.codec != WireCodec::wireCodecJPEG
+			&& header.codec != WireCodec::wireCodecPNG) {
+		error = "unknown codec " + utilities::NumberToString(header.codec);
+		return false;
+	}
+	if (header.payloadSize > 2 * header.step * header.rows + 4096) {
+		error = "encoded payload too large";
+		return false;
+	}
+	return true;
+}
+
+void applyWireHeader(const WireHeader& header, MessageData& msg, FramePool& pool) {
+	msg.mCommand = (Command)header.command;
+	msg.mLapNo = header.lapNo;
+	msg.mversion = header.version;
+	msg.mTimeStamp = header.timeStamp == INT64_MIN ? boost::posix_time::ptime()
+			: wireEpoch + boost::posix_time::microseconds(header.timeStamp);
+	msg.mCommandIndex = header.commandIndex;
+	if (header.payloadSize == 0) {
+		msg.mImg.release();
+	}
+	else {
+		msg.mImg = pool.acquire(cv::Size(header.cols, header.rows), header.matType);
+	}
+}
+
+void writeWireMessage(const MessageData& msg, std::vector<char>& buffer) {
+	const WireHeader header = makeWireHeader(msg);
+	buffer.resize(sizeof(header) + header.payloadSize);
+	std::memcpy(&buffer[0], &header, sizeof(header));
+	char* payload = &buffer[sizeof(header)];
+	for (int row = 0; row < header.rows; row++) {
+		std::memcpy(payload + row * header.step, msg.mImg.ptr(row), header.step);
+	}
+}
+
+void readWirePayload(const WireHeader& header, const char* payload, MessageData& msg) {
+	if (msg.mImg.isContinuous()) {
+		std::memcpy(msg.mImg.data, payload, header.payloadSize);
+		return;
+	}
+	for (int row = 0; row < header.rows; row++) {
+		std::memcpy(msg.mImg.ptr(row), payload + row * header.step, header.step);
+	}
+}
@@ -0,0 +1,93 @@
+/*
+ * wire_format.h
+ *
+ *  Binary frame format between the laptops, replacing boost text archives:
+ *  a fixed WireHeader followed by the raw pixel rows of MessageData::mImg.
+ *  Fields are in host byte order (both ends are x86), the header starts with
+ *  a magic number and a version so receivers can tell it from the old
+ *  format, which starts with the body length as size_t.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef WIRE_FORMAT_H_
+#define WIRE_FORMAT_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "message_data.h"
+#include "frame_pool.h"
+
+//which format a sender uses, receivers accept both
+enum WireFormat {
+	wireFormatText,		//boost text archive, for peers running an old build
+	wireFormatBinary
+};
+
+extern WireFormat getWireFormat();
+extern void setWireFormat(WireFormat);
+
+//encoding of the payload, agreed on per connection, see wire_codec.h
+enum WireCodec {
+	wireCodecRaw,		//packed pixel rows
+	wireCodecJPEG,
+	wireCodecPNG		//lossless
+};
+
+struct WireHeader {
+	static const uint32_t magicNumber = 0x46575244; // "DRWF"
+	static const uint16_t currentVersion = 2;
+
+	uint32_t magic;
+	uint16_t version;
+	uint16_t headerSize;	// sizeof(WireHeader) of the sender, later versions may append fields
+	int32_t command;
+	int32_t lapNo;
+	int64_t timeStamp;		// microseconds since 1970-01-01, INT64_MIN if not set
+	int32_t commandIndex;
+	int32_t matType;
+	int32_t rows;
+	int32_t cols;
+	uint64_t step;			// bytes per row of the image, in a raw payload rows are packed
+	uint64_t payloadSize;	// rows * step if raw, else the size of the encoded image
+	// version 2
+	int32_t codec;			// WireCodec, raw in older versions
+	int32_t quality;		// JPEG quality, in the hello message the highest one the sender wants to use
+};
+
+static_assert(sizeof(WireHeader) == 64, "WireHeader must have the same layout on both laptops");
+
+//size of a version 1 header, the part every receiver reads before looking at headerSize
+const size_t wireHeaderSizeV1 = 56;
+
+//bytes to read after the first wireHeaderSizeV1 ones: the rest of this version's fields, then fields of a newer version
+size_t wireHeaderTail(const WireHeader& header);
+size_t wireHeaderExtra(const WireHeader& header);
+
+//length of the prefix a receiver reads first: a WireHeader or the size_t body length of the old format
+const size_t wirePrefixSize = 8;
+
+//whether the first wirePrefixSize bytes of a message start a WireHeader
+bool isWireHeader(const void* prefix);
+
+//header for a message, the raw payload being the rows of msg.mImg
+WireHeader makeWireHeader(const MessageData& msg);
+
+//check a received header, set error and return false if it cannot be read
+//the first wireHeaderSizeV1 bytes are enough to check the version, all of them are needed for the payload
+bool checkWireHeader(const WireHeader& header, std::string& error);
+
+//fill all fields but the pixels from a checked header, msg.mImg gets a buffer of the right shape from the pool
+void applyWireHeader(const WireHeader& header, MessageData& msg, FramePool& pool);
+
+//whole message as one contiguous buffer: header, then payload
+void writeWireMessage(const MessageData& msg, std::vector<char>& buffer);
+
+//copy a received payload into msg.mImg prepared by applyWireHeader()
+void readWirePayload(const WireHeader& header, const char* payload, MessageData& msg);
+
+#endif /* WIRE_FORMAT_H_ */
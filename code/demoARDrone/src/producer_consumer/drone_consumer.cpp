@@ -44,9 +44,19 @@ void DroneConsumerClient::operator ()() {
 	    //http://stackoverflow.com/questions/16365561/boost-threading-and-mutexes-in-a-functor
 	    //explain while we need to use boost::ref, because copy not allow in boost::mutex.
 	    boost::thread t_client2 = boost::thread(&client2::process_sender, boost::ref(c) ) ;
+	    //frames go over UDP instead of the connection of client2, which then only says hello
+	    boost::shared_ptr<udp_frame_sender> udpSender;
+	    boost::thread t_udp_sender;
+	    if (getUdpFrames()) {
+	    	udpSender.reset(new udp_frame_sender(io_service, this->mhostDst, this->mportDst));
+	    	t_udp_sender = boost::thread(&udp_frame_sender::process_sender, udpSender.get());
+	    }
 	    //-------------------
-	    io_service.run();
+	    runIoService(io_service, getNetworkThreads());
 	    t_client2.join();
+	    if (t_udp_sender.joinable()) {
+	    	t_udp_sender.join();
+	    }
 
 //
 //
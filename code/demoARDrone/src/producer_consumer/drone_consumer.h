@@ -13,6 +13,7 @@
 #include <opencv2/core/core.hpp>
 #include "hawaii/GPU/autoMat.h"
 #include "sender_receiver.h"
+#include "udp_transport.h"
 #include <list>
 
 namespace producer_consumer_thread {
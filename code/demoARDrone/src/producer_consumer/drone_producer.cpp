@@ -7,6 +7,7 @@
 
 #include "drone_producer.h"
 #include "hawaii/common/helpers.h"
+#include "visualSink.h"
 #include <opencv2/imgproc/imgproc.hpp>
 #include <SDL/SDL_keysym.h>
 #include <SDL/SDL_joystick.h>
@@ -226,10 +227,10 @@ void DroneProducer::processImageFront( const cv_bridge::CvImage imageFront ) {
 
 		MessageData msg;
 		msg.mLapNo = this->mThreadNo;
-		msg.mImg = visualization.clone();
+		msg.mImg = GloFramePool.copyOf(visualization);
 		msg.mTimeStamp = boost::posix_time::microsec_clock::local_time();
 
-		this->setData(msg);
+		this->setData(std::move(msg));
 
 		//boost::this_thread::sleep(boost::posix_time::milliseconds(1000/mMaximumFrameRate));
 
@@ -265,15 +266,10 @@ void DroneProducer::processKeystrokes() {
 
 DroneProducer1::DroneProducer1(int n, int TimeBetweenImages):
 				DroneProducer(n, TimeBetweenImages),
+				synchronizer_(2, 1),
 				sparse3D2( this->focalLengthFrontU,
 						this->principalPointFrontU,
 						this->principalPointFrontV ){
-	md_Stream1_ = NULL;
-	md_Stream2_ = NULL;
-
-	md_CurrentStream1_ = NULL;
-	md_CurrentStream2_ = NULL;
-
 	this->consumerThread_ = boost::thread( &DroneProducer1::consume, this ) ;
 }
 
@@ -313,12 +309,12 @@ void DroneProducer1::processImageFront( const cv_bridge::CvImage imageFront ) {
 
 		MessageData msg;
 		msg.mLapNo = this->mThreadNo;
-		msg.mImg = visualization.clone();
+		msg.mImg = GloFramePool.copyOf(visualization);
 		using namespace boost::posix_time;
 		using namespace boost::gregorian;
 		msg.mTimeStamp = boost::posix_time::microsec_clock::local_time();
 
-		this->setData(msg);
+		this->setData(std::move(msg));
 
 		//boost::this_thread::sleep(boost::posix_time::milliseconds(1000/mMaximumFrameRate));
 
@@ -419,7 +415,7 @@ void DroneProducer1::consume() {
 			if (diff.total_milliseconds() > 2500) {
 				//drop packet
 				printing("time for sending a packet from PC 2: " + utilities::NumberToString(diff.total_milliseconds()));
-				printing("drop old packet!");
+				printing("drop old packet! dropped by queue so far: " + utilities::NumberToString(GloQueueData.dropped()));
 				continue;
 			}
 			if (msg.mLapNo == 2) {
@@ -432,12 +428,11 @@ void DroneProducer1::consume() {
 		//		+ std::string((value.isCommandMessage(Command::CloseConnection) ? "true": "false")));
 		if (msg.isCommandMessage(Command::CloseConnection)) {
 			//printing("DroneConsumer stopping getting message ");
-			cv::waitKey(5000);
+			VisualSink::instance().waitKey(5000);
 			break;
 		}
 
-		cv::imshow(std::string("Drone ") + utilities::NumberToString(msg.mLapNo), msg.mImg );
-		cv::waitKey(1);
+		VisualSink::instance().show(std::string("Drone ") + utilities::NumberToString(msg.mLapNo), msg.mImg );
 
 		if (msg.mLapNo == 2)
 		{
@@ -451,83 +446,19 @@ void DroneProducer1::consume() {
 			//logging2("TIME: msg queue, process", 1, diff.total_milliseconds());
 		}
 
-		//synchronize two streams into 1
-		//condition: know that stream 1 is send more frames/s than stream 2.
-		if (md_Stream1_ == NULL || md_Stream2_ == NULL) {
-			//printing("md_Stream1_ == NULL || md_Stream2_ == NULL");
-			if (msg.mLapNo == 2) {
-				md_Stream2_ = new MessageData(msg);
-			}
-			else {
-				//Lapno = 1 --> add to waiting list
-				listWaitingSynchronizeStream_.push_back(msg);
+		//synchronize two streams into 1: each frame of stream 2 with the nearest one of stream 1
+		//a late frame of stream 1 may complete several waiting frames of stream 2 at once
+		synchronizer_.add(msg.mLapNo == 2 ? 1 : 0, msg);
+		while (synchronizer_.pop(synchronizedFrames_)) {
+			if (synchronizer_.matched() % 100 == 0) {
+				printing("synchronized pairs: " + utilities::NumberToString(synchronizer_.matched())
+						+ ", unmatched: " + utilities::NumberToString(synchronizer_.unmatched())
+						+ ", dropped: " + utilities::NumberToString(synchronizer_.dropped()));
 			}
-		}
-
-		//compare diff in order to find the best pair (the increasing of diff time)
-		if (md_Stream1_ == NULL && md_Stream2_ != NULL) {
-			//printing("md_Stream1_ == NULL && md_Stream2_ != NULL");
-			std::list<MessageData>::iterator iterator;
-			boost::posix_time::time_duration diff1;
-			boost::posix_time::time_duration diff2;
-			for (iterator = listWaitingSynchronizeStream_.begin(); iterator != listWaitingSynchronizeStream_.end(); ++iterator) {
-				//update diff 1 if current iterator in the begining
-				if (iterator == listWaitingSynchronizeStream_.begin()) {
-					if (md_Stream2_->mTimeStamp > iterator->mTimeStamp) {
-						diff1 = md_Stream2_->mTimeStamp - iterator->mTimeStamp;
-					}
-					else {
-						diff1 = -(md_Stream2_->mTimeStamp - iterator->mTimeStamp);
-					}
-				}
-				else {//update diff 2
-					if (md_Stream2_->mTimeStamp > iterator->mTimeStamp) {
-						diff2 = md_Stream2_->mTimeStamp - iterator->mTimeStamp;
-					}
-					else {
-						diff2 = -(md_Stream2_->mTimeStamp - iterator->mTimeStamp);
-					}
-				}
-
-				//std::cout<<"diff1"<<diff1<<"diff2"<<diff2<<std::endl;
-				if (iterator != listWaitingSynchronizeStream_.begin() && diff1 < diff2) {
-					//printing("iterator != listWaitingSynchronizeStream_.begin() && diff1 < diff2");
-					--iterator;// get the first pair
-					//std::cout<<"diff1"<< diff1<<std::endl;
-					md_Stream1_ = new MessageData((*iterator));
-					//remove used waiting list
-
-					std::list<MessageData>::iterator iterator_remover;
-					iterator_remover = listWaitingSynchronizeStream_.begin();
-					while (iterator_remover != iterator)
-					{
-						listWaitingSynchronizeStream_.erase(iterator_remover++);  // alternatively, i = items.erase(i);
-					}
-					break;
-				}
-
-				if (iterator != listWaitingSynchronizeStream_.begin()) {
-					diff1 = diff2;
-				}
-			}
-		}
-
-		if (md_Stream1_ != NULL && md_Stream2_ != NULL) {
-			//printing("md_Stream1_ != NULL && md_Stream2_ != NULL");
-			//add to current stream
-			md_CurrentStream1_ = md_Stream1_;
-			md_CurrentStream2_ = md_Stream2_;
-
-			md_Stream1_ = NULL;
-			md_Stream2_ = NULL;
 			//merge into 1 and show image
-
-			cv::imshow("stream 1", md_CurrentStream1_->mImg );
-			cv::waitKey(1);
-			cv::imshow("stream 2", md_CurrentStream2_->mImg );
-			cv::waitKey(1);
-			this->process2ImageStreams(md_CurrentStream1_, md_CurrentStream2_);
-
+			VisualSink::instance().show("stream 1", synchronizedFrames_[0].mImg );
+			VisualSink::instance().show("stream 2", synchronizedFrames_[1].mImg );
+			this->process2ImageStreams(&synchronizedFrames_[0], &synchronizedFrames_[1]);
 		}
 	}
 	//----------------------------------------------------------------------
@@ -536,7 +467,8 @@ void DroneProducer1::consume() {
 
 void DroneProducer1::process2ImageStreams(MessageData *stream1, MessageData *stream2) {
 	// keep original image for visualization, create GPU-suitable copies in color and (slightly blurred) grayscale
-	cv::Mat visualization = stream1->mImg;
+	// the frame is shared with other messages, so draw into a copy
+	cv::Mat visualization = stream1->mImg.clone();
 
 	//pre-processing for image stream 1
 	hawaii::AutoMat imageBGR1, imageGray1, imageGraySmooth1 ;
@@ -591,9 +523,8 @@ void DroneProducer1::process2ImageStreams(MessageData *stream1, MessageData *str
 	if( 1
 			|| this->keystates[ SDLK_v ]
 			                    || this->buttons[ buttonBlue ] ) {
-		HAWAII_IMSHOW( visualization ) ;
+		VISUAL_SHOW( visualization ) ;
 	}
-	cv::waitKey( 1 ) ;
 }
 
 //--------------------------------------------------------------------------
@@ -693,10 +624,16 @@ void DroneProducerServer::operator()() {
 		//-------------------
 		server s(io_service, utilities::StringToNumber(this->mportSrc), 1);
 		client1 c(io_service, this->mhostDst, this->mportDst);
+		//frames from laptop 2 over UDP, on the port number of the server
+		boost::shared_ptr<udp_frame_receiver> udpReceiver;
+		if (getUdpFrames()) {
+			udpReceiver.reset(new udp_frame_receiver(io_service, utilities::StringToNumber(this->mportSrc),
+					&udp_frame_receiver::pushToQueue));
+		}
 		//-------------------
 		boost::thread t_client1 = boost::thread(&client1::process_sender, boost::ref(c) ) ;
 		//-------------------
-		io_service.run();
+		runIoService(io_service, getNetworkThreads());
 		t_client1.join();
 
 
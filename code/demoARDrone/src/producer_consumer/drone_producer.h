@@ -14,6 +14,7 @@
 #include "producer_consumer.h"
 #include <opencv2/core/core.hpp>
 #include "sender_receiver.h"
+#include "udp_transport.h"
 #include "base/base_services.h"
 #include "../sparse3D2.h"
 
@@ -133,12 +134,9 @@ protected:
 //	}
 
 protected:
-	std::list<MessageData> listWaitingSynchronizeStream_;
-	MessageData *md_Stream1_;
-	MessageData *md_Stream2_;
-
-	MessageData *md_CurrentStream1_;
-	MessageData *md_CurrentStream2_;
+	//pairs frames of lap 1 (stream 0) with the slower ones of lap 2 (stream 1)
+	StreamSynchronizer synchronizer_;
+	std::vector<MessageData> synchronizedFrames_;
 
 	//remake sparse3D demo
 protected:
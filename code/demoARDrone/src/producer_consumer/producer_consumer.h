@@ -29,6 +29,10 @@ public:
 		GloQueueData.push(data);
 		return true;
 	}
+	virtual bool setData(MessageData&& data) {
+		GloQueueData.push(std::move(data));
+		return true;
+	}
 	//support consumer
 	virtual void getData(MessageData& data) {
 		GloQueueData.wait_and_pop(data);
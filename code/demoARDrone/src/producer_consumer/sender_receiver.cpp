@@ -6,6 +6,7 @@
  */
 
 #include "sender_receiver.h"
+#include "udp_transport.h"
 
 //------------------------------------------------------------------------
 //client1
@@ -68,6 +69,11 @@ void client2::process_sender() {
 
 			if (this->checkConnectionState(ConnectionState::activeConnection)) {
 				printing("activeConnection");
+				//udp_frame_sender takes the frames
+				if (getUdpFrames()) {
+					setIsProcessingMessage(false);
+					continue;
+				}
 				GloQueueData.wait_and_pop(msg);
 				this->asyn_sendMessage(msg);
 				setIsProcessingMessage(false);
@@ -76,3 +82,88 @@ void client2::process_sender() {
 			//setIsProcessingMessage(false);
 		}
 	}
+
+//------------------------------------------------------------------------
+//io_service pool
+void runIoService(boost::asio::io_service& io_service, size_t threads) {
+	boost::thread_group pool;
+	for (size_t i = 1; i < threads; i++) {
+		pool.create_thread([&io_service]() { io_service.run(); });
+	}
+	io_service.run();
+	pool.join_all();
+}
+
+//------------------------------------------------------------------------
+//loopback benchmark of the stream router
+void streamRouterTest(unsigned short port, size_t streams, size_t threads, int frames) {
+	boost::asio::io_service io_service;
+	//every frame is counted, so the sessions wait for slow consumers
+	stream_router router(streams, 16, overflow_policy::block_when_full);
+	server s(io_service, port, router);
+	boost::asio::io_service::work work(io_service);
+	boost::thread t_io = boost::thread([&io_service, threads]() { runIoService(io_service, threads); });
+
+	//one consumer per stream, until its sender closes
+	std::vector<int> received(router.streams(), 0);
+	boost::thread_group consumers;
+	for (size_t i = 0; i < router.streams(); i++) {
+		consumers.create_thread([&router, &received, i]() {
+			MessageData msg;
+			while (true) {
+				router.queue(i).wait_and_pop(msg);
+				if (msg.isCommandMessage(Command::CloseConnection)) break;
+				received[i]++;
+			}
+		});
+	}
+
+	//one blocking sender per stream, like a laptop with a drone each
+	const boost::posix_time::ptime started = boost::posix_time::microsec_clock::local_time();
+	boost::thread_group senders;
+	for (size_t i = 0; i < router.streams(); i++) {
+		senders.create_thread([port, i, frames]() {
+			boost::asio::io_service io_service_sender;
+			tcp::socket socket(io_service_sender);
+			socket.connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+			std::vector<char> buffer;
+
+			MessageData msg = MessageData::createMessage(Command::ClientSendInfoToServer);
+			msg.mLapNo = (int)i + 1;
+			writeWireMessage(msg, buffer);
+			boost::asio::write(socket, boost::asio::buffer(buffer));
+			//unread data would make closing the socket reset the connection before the frames are read
+			WireHeader reply;
+			boost::asio::read(socket, boost::asio::buffer(&reply, sizeof(reply)));
+
+			msg = MessageData::createMessage(Command::NoCommand);
+			msg.mImg = cv::Mat(360, 640, CV_8UC3);
+			msg.mImg.setTo(cv::Scalar(i, i, i));
+			for (int frame = 0; frame < frames; frame++) {
+				msg.mLapNo = frame;
+				msg.mTimeStamp = boost::posix_time::microsec_clock::local_time();
+				writeWireMessage(msg, buffer);
+				boost::asio::write(socket, boost::asio::buffer(buffer));
+			}
+
+			msg = MessageData::createMessage(Command::CloseConnection);
+			writeWireMessage(msg, buffer);
+			boost::asio::write(socket, boost::asio::buffer(buffer));
+		});
+	}
+	senders.join_all();
+	consumers.join_all();
+	const double seconds = (boost::posix_time::microsec_clock::local_time() - started).total_microseconds() / 1e6;
+	io_service.stop();
+	t_io.join();
+
+	int total = 0;
+	for (size_t i = 0; i < received.size(); i++) {
+		printing("stream " + utilities::NumberToString((int)i) + ": frames received " + utilities::NumberToString(received[i]));
+		total += received[i];
+	}
+	printing("stream router: " + utilities::NumberToString((int)router.streams()) + " streams, "
+			+ utilities::NumberToString((int)threads) + " threads, "
+			+ utilities::NumberToString(total) + " frames in " + utilities::NumberToString((int)(seconds * 1000)) + " ms, "
+			+ utilities::NumberToString((int)(total / seconds)) + " frames/s");
+}
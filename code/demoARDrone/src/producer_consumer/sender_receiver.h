@@ -9,15 +9,19 @@
 #define SENDER_RECEIVER_HPP_
 //netstat --listen
 
+#include <atomic>
+#include <cstring>
 #include <ctime>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/asio.hpp>
 
 #include "base/base_services.h"
+#include "stream_router.h"
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
@@ -41,11 +45,12 @@ enum ConnectionState {
 	inactive
 };
 
-class session_server_base
+//one connection, kept alive by the handlers of its pending operations
+class session_server_base: public boost::enable_shared_from_this<session_server_base>
 {
 public:
 	session_server_base(boost::asio::io_service& io_service)
-	: socket_(io_service)
+	: io_service_(io_service), socket_(io_service), wireVersionReceived_(0)
 	{
 	}
 
@@ -76,9 +81,9 @@ public:
 	}
 	void asyn_getMessage()
 	{
-		//start to receive something
-		socket_.async_read_some(boost::asio::buffer(&header_, sizeof(header_)),
-				boost::bind(&session_server_base::handle_read_header, this,
+		//start to receive something: the prefix tells the binary format from the old text format
+		boost::asio::async_read(socket_, boost::asio::buffer(prefix_, wirePrefixSize),
+				boost::bind(&session_server_base::handle_read_header, shared_from_this(),
 						boost::asio::placeholders::error,
 						boost::asio::placeholders::bytes_transferred));
 	}
@@ -88,28 +93,34 @@ public:
 	{
 		if (!error)
 		{
-			printing("Body message: " + utilities::NumberToString(header_) + " bytes, transfered: " + utilities::NumberToString(bytes_transferred));
-			if (sizeof(header_) == 4) // in case 32 bits, add more 4 bits to align with 64bits system
-			{
-				//printing("read more 4 bytes" );
-				unsigned int a;
-				boost::system::error_code error2;
-				socket_.read_some(boost::asio::buffer( &a, sizeof(a) ), error2);
+			if (isWireHeader(prefix_)) {
+				//fields of version 2 keep their defaults for a version 1 sender
+				wireHeader_.codec = WireCodec::wireCodecRaw;
+				wireHeader_.quality = 0;
+				std::memcpy(&wireHeader_, prefix_, wirePrefixSize);
+				boost::asio::async_read(socket_,
+						boost::asio::buffer(reinterpret_cast<char*>(&wireHeader_) + wirePrefixSize, wireHeaderSizeV1 - wirePrefixSize),
+						boost::bind(&session_server_base::handle_read_wire_header, shared_from_this(),
+								boost::asio::placeholders::error));
+				return;
 			}
 
+			//old format: body length as size_t, padded to 64 bits by 32 bits senders
+			uint64_t length;
+			std::memcpy(&length, prefix_, sizeof(length));
+			header_ = length;
+			printing("Body message: " + utilities::NumberToString(header_) + " bytes, transfered: " + utilities::NumberToString(bytes_transferred));
+
 			//--------------------------------------------------------------------------------------
 			// read body
 			remain_ = header_;
 
 			socket_.async_read_some(streambuf_.prepare(remain_),
-					boost::bind(&session_server_base::handle_read_body, this,
+					boost::bind(&session_server_base::handle_read_body, shared_from_this(),
 							boost::asio::placeholders::error,
 							boost::asio::placeholders::bytes_transferred));
 		}
-		else
-		{
-			delete this;
-		}
+		//else the session ends with the last handler holding it, closing the socket
 	}
 
 	void handle_read_body(const boost::system::error_code& error,
@@ -124,7 +135,7 @@ public:
 				streambuf_.commit(bytes_transferred);
 				if (remain_ > 0) {
 					socket_.async_read_some(streambuf_.prepare(remain_),
-							boost::bind(&session_server_base::handle_read_body, this,
+							boost::bind(&session_server_base::handle_read_body, shared_from_this(),
 									boost::asio::placeholders::error,
 									boost::asio::placeholders::bytes_transferred));
 				}
@@ -136,131 +147,262 @@ public:
 
 					MessageData msg;
 					ar >> msg;
+					wireVersionReceived_ = 0;
 					this->process_receiver(msg);
 				}
 			}
 		}
-		else
-		{
-			delete this;
-		}
 	}
 
-private:
-	tcp::socket socket_;
-
-	//for header
-	size_t header_;
+	void handle_read_wire_header(const boost::system::error_code& error)
+	{
+		if (error) {
+			return;
+		}
+		if (wireHeader_.headerSize < wireHeaderSizeV1 || wireHeader_.headerSize > 4096) {
+			printing("[ERROR] handle_read_wire_header: header size " + utilities::NumberToString(wireHeader_.headerSize));
+			return;
+		}
 
-	//for body
-	boost::asio::streambuf streambuf_;
-	size_t remain_;
-};
+		//the rest of the header: fields up to this version's, then fields appended by a newer version, which are ignored
+		wireBuffers_.clear();
+		const size_t tail = wireHeaderTail(wireHeader_);
+		if (tail > 0) {
+			wireBuffers_.push_back(boost::asio::buffer(reinterpret_cast<char*>(&wireHeader_) + wireHeaderSizeV1, tail));
+		}
+		wireExtra_.resize(wireHeaderExtra(wireHeader_));
+		if (!wireExtra_.empty()) {
+			wireBuffers_.push_back(boost::asio::buffer(wireExtra_));
+		}
+		if (wireBuffers_.empty()) {
+			this->handle_read_wire_header_rest(error);
+			return;
+		}
+		boost::asio::async_read(socket_, wireBuffers_,
+				boost::bind(&session_server_base::handle_read_wire_header_rest, shared_from_this(),
+						boost::asio::placeholders::error));
+	}
 
-class session_server1: public session_server_base {
-public:
-	session_server1(boost::asio::io_service& io_service)
-	: session_server_base(io_service)
+	void handle_read_wire_header_rest(const boost::system::error_code& error)
 	{
+		if (error) {
+			return;
+		}
+		std::string strError;
+		if (!checkWireHeader(wireHeader_, strError)) {
+			//the stream cannot be resynchronized
+			printing("[ERROR] handle_read_wire_header: " + strError);
+			return;
+		}
+		applyWireHeader(wireHeader_, wireMessage_, GloFramePool);
+
+		//a raw payload is read straight into the pooled Mat, row by row if it has gaps,
+		//an encoded one into wireEncoded_ for the codec worker
+		wireBuffers_.clear();
+		cv::Mat& image = wireMessage_.mImg;
+		if (wireHeader_.payloadSize > 0 && wireHeader_.codec != WireCodec::wireCodecRaw) {
+			wireEncoded_.resize(wireHeader_.payloadSize);
+			wireBuffers_.push_back(boost::asio::buffer(wireEncoded_));
+		}
+		else if (wireHeader_.payloadSize > 0 && image.isContinuous()) {
+			wireBuffers_.push_back(boost::asio::buffer(image.data, wireHeader_.payloadSize));
+		}
+		else if (wireHeader_.payloadSize > 0) {
+			for (int row = 0; row < image.rows; row++) {
+				wireBuffers_.push_back(boost::asio::buffer(image.ptr(row), wireHeader_.step));
+			}
+		}
+		if (wireBuffers_.empty()) {
+			this->handle_read_wire_body(error);
+			return;
+		}
+		boost::asio::async_read(socket_, wireBuffers_,
+				boost::bind(&session_server_base::handle_read_wire_body, shared_from_this(),
+						boost::asio::placeholders::error));
 	}
 
-	virtual void process_receiver(MessageData & msg) override {
-		//after finish asyn_getMessage, call this function for process that Message
-		//printing("msg command: " + utilities::NumberToString(msg.mCommand));
-		if (msg.isCommandMessage(Command::ClientSendInfoToServer)) {
-			this->changeConnectionState(ConnectionState::activeConnection);
-			this->asyn_getMessage();
+	void handle_read_wire_body(const boost::system::error_code& error)
+	{
+		if (error) {
 			return;
 		}
-		if (this->checkConnectionState(ConnectionState::activeConnection)) {
-			printing("activeConnection");
+		if (wireMessage_.isCommandMessage(Command::ClientSendInfoToServer) && wireHeader_.version >= 2) {
+			this->reply_hello();
+		}
+		if (wireHeader_.payloadSize > 0 && wireHeader_.codec != WireCodec::wireCodecRaw) {
+			//decode off the io_service thread, the next message is read once this one is processed
+			boost::shared_ptr<session_server_base> self = shared_from_this();
+			codec_worker::instance().post([this, self]() {
+				MessageData msg(std::move(wireMessage_));
+				const bool decoded = decodeWirePayload(wireHeader_, wireEncoded_, msg);
+				io_service_.post(boost::bind(&session_server_base::handle_decoded, self, msg, decoded));
+			});
+			return;
+		}
+		MessageData msg(std::move(wireMessage_));
+		wireVersionReceived_ = wireHeader_.version;
+		this->process_receiver(msg);
+	}
 
-			GloQueueData.push(msg);
+	void handle_decoded(MessageData msg, bool decoded)
+	{
+		if (!decoded) {
+			printing("[ERROR] handle_decoded: payload does not match the header, frame dropped");
 			this->asyn_getMessage();
 			return;
-			//			if (msg.isCommandMessage(Command::CloseConnection)) {
-			//				this->setCloseConnection(true);
-			//				printing("Receiver - Close connection!");
-			//				break;
-			//			}
 		}
+		wireVersionReceived_ = wireHeader_.version;
+		this->process_receiver(msg);
 	}
-};
 
+	//answer the codec offered in a hello message with the one accepted for this connection
+	void reply_hello()
+	{
+		MessageData hello = MessageData::createMessage(Command::ClientSendInfoToServer);
+		boost::shared_ptr<WireHeader> reply(new WireHeader(makeWireHeader(hello)));
+		reply->codec = acceptWireCodec(wireHeader_.codec);
+		reply->quality = wireHeader_.quality;
+		printing("codec accepted: " + utilities::NumberToString(reply->codec));
+		boost::asio::async_write(socket_,
+				boost::asio::buffer(reply.get(), sizeof(WireHeader)),
+				boost::bind(&session_server_base::handle_write_reply, shared_from_this(),
+						boost::asio::placeholders::error, reply));
+	}
+
+	//binary format version of the message passed to process_receiver(), 0 for the old text format
+	int wireVersionReceived() const { return wireVersionReceived_; }
+
+	//only holds the reply until here, errors show up on the next read
+	void handle_write_reply(const boost::system::error_code& error, boost::shared_ptr<WireHeader> /*reply*/)
+	{
+		if (error) {
+			printing("[ERROR] handle_write_reply: " + error.message());
+		}
+	}
+
+private:
+	boost::asio::io_service& io_service_;
+	tcp::socket socket_;
 
-class session_server2: public session_server_base {
+	//for header
+	char prefix_[wirePrefixSize];
+	size_t header_;
+
+	//for binary messages
+	WireHeader wireHeader_;
+	MessageData wireMessage_;
+	std::vector<char> wireExtra_;
+	std::vector<uchar> wireEncoded_;
+	std::vector<boost::asio::mutable_buffer> wireBuffers_;
+	int wireVersionReceived_;
+
+	//for body
+	boost::asio::streambuf streambuf_;
+	size_t remain_;
+};
+
+//session of one stream: frames of a drone, or commands
+class session_stream: public session_server_base {
 public:
-	session_server2(boost::asio::io_service& io_service)
-	: session_server_base(io_service)
+	session_stream(boost::asio::io_service& io_service, stream_router& router, size_t defaultStream)
+	: session_server_base(io_service), router_(router), defaultStream_(defaultStream), stream_(defaultStream)
 	{
 	}
+
+	size_t stream() const { return stream_; }
+
 	virtual void process_receiver(MessageData & msg) override {
 		//after finish asyn_getMessage, call this function for process that Message
-		//printing("msg command: " + utilities::NumberToString(msg.mCommand));
 		if (msg.isCommandMessage(Command::ClientSendInfoToServer)) {
+			//a binary hello of version 2 names the stream as its ID + 1, older builds leave
+			//whatever lap they were at in mLapNo, so text hellos and version 1 ones get the default
+			stream_ = defaultStream_;
+			if (this->wireVersionReceived() >= 2 && msg.mLapNo > 0) {
+				stream_ = msg.mLapNo - 1;
+			}
+			if (stream_ >= router_.streams()) {
+				printing("[ERROR] session_stream: no stream " + utilities::NumberToString((int)stream_) + ", using stream " + utilities::NumberToString((int)defaultStream_));
+				stream_ = defaultStream_;
+			}
+			printing("session of stream " + utilities::NumberToString((int)stream_));
 			this->changeConnectionState(ConnectionState::activeConnection);
 			this->asyn_getMessage();
 			return;
 		}
 		if (this->checkConnectionState(ConnectionState::activeConnection)) {
-			//printing("activeConnection");
-			printing("Message command: index: " + utilities::NumberToString(msg.mCommandIndex) + " command: "  + utilities::NumberToString(msg.mCommand));
-			//GloQueueData.push(msg);
-			GloQueueCommand.push(msg);
+			router_.route(stream_, msg);
 			this->asyn_getMessage();
 			return;
-
 		}
 	}
+
+private:
+	stream_router& router_;
+	size_t defaultStream_;
+	size_t stream_;
 };
+
 //create this class in DroneConsumer and DroneProducer
 class server
 {
 public:
+	//sessions route into router, to defaultStream unless their binary hello names another one
+	server(boost::asio::io_service& io_service, short port, stream_router& router, size_t defaultStream = 0)
+	: io_service_(io_service),
+	  acceptor_(io_service, tcp::endpoint(tcp::v4(), port)),
+	  router_(router),
+	  defaultStream_(defaultStream)
+	{
+		printing("LISTENING port: " + utilities::NumberToString(port));
+		asyn_accept();
+	}
+
+	//single drone: laptop 1 receives frames into GloQueueData, laptop 2 commands into GloQueueCommand
 	server(boost::asio::io_service& io_service, short port, int lapNo)
 	: io_service_(io_service),
-	  acceptor_(io_service, tcp::endpoint(tcp::v4(), port))
+	  acceptor_(io_service, tcp::endpoint(tcp::v4(), port)),
+	  ownRouter_(new stream_router(1)),
+	  router_(*ownRouter_),
+	  defaultStream_(0)
 	{
 		printing("LISTENING port: " + utilities::NumberToString(port));
-		session_server_base* new_session;
-		if (lapNo == 1) {
-			new_session = new session_server1(io_service_);
-		}
-		else {
-			new_session = new session_server2(io_service_);
-		}
+		router_.setSink(0, lapNo == 1 ? &stream_router::sinkToQueueData : &stream_router::sinkToQueueCommand);
+		asyn_accept();
+	}
+
+	void asyn_accept()
+	{
+		boost::shared_ptr<session_stream> new_session(new session_stream(io_service_, router_, defaultStream_));
 		acceptor_.async_accept(new_session->socket(),
 				boost::bind(&server::handle_accept, this, new_session,
 						boost::asio::placeholders::error));
 	}
 
-	void handle_accept(session_server_base* new_session,
+	void handle_accept(boost::shared_ptr<session_stream> new_session,
 			const boost::system::error_code& error)
 	{
 		if (!error)
 		{
 			new_session->asyn_getMessage();
-			new_session = new session_server_base(io_service_);
-			acceptor_.async_accept(new_session->socket(),
-					boost::bind(&server::handle_accept, this, new_session,
-							boost::asio::placeholders::error));
-		}
-		else
-		{
-			//delete new_session;
-			//show the error, continue listening util have the signal of stopping
-			new_session = new session_server_base(io_service_);
-			acceptor_.async_accept(new_session->socket(),
-					boost::bind(&server::handle_accept, this, new_session,
-							boost::asio::placeholders::error));
 		}
+		//show the error, continue listening util have the signal of stopping
+		asyn_accept();
 	}
 
 private:
 	boost::asio::io_service& io_service_;
 	tcp::acceptor acceptor_;
+	boost::shared_ptr<stream_router> ownRouter_;
+	stream_router& router_;
+	size_t defaultStream_;
 };
 
+//run io_service on the calling thread and threads - 1 more, return when it runs out of work or is stopped
+void runIoService(boost::asio::io_service& io_service, size_t threads);
+
+//loopback benchmark: streams clients sending synthetic frames to one server running on threads threads
+void streamRouterTest(unsigned short port, size_t streams, size_t threads, int frames);
+
 
 //---------------------------------------------------------------------------------------------------------
 //firstly, build up a sender in here to replace for the old one
@@ -269,6 +411,8 @@ class client
 private:
 	boost::asio::io_service& io_service_;
 	tcp::socket socket_;
+	//the sender thread and the io_service pool both start operations on socket_, always through here
+	boost::asio::io_service::strand strand_;
 	std::string hostDst_, portDst_;
 
 public:
@@ -289,7 +433,11 @@ public:
 			std::string hostDst, std::string portDst)
 	: io_service_(io_service),
 	  socket_(io_service),
-	  mt_protectIsProcessingMessage()
+	  strand_(io_service),
+	  mt_protectIsProcessingMessage(),
+	  helloLapNo_(0),
+	  codecAccepted_(WireCodec::wireCodecRaw),
+	  writesPending_(0)
 	{
 		this->changeConnectionState(ConnectionState::Step2);
 		hostDst_ = hostDst;
@@ -311,6 +459,12 @@ public:
 
 	}
 
+	//stream of the server this client sends to, see session_stream, before the hello is sent;
+	//only a binary hello carries it, with the text format the server takes its default
+	void setStream(size_t stream) {
+		helloLapNo_ = (int)stream + 1;
+	}
+
 	ConnectionState mconnectionState;
 	mutable boost::mutex mutex_connectionState;
 	bool checkConnectionState(const ConnectionState& currentState) {
@@ -382,12 +536,56 @@ public:
 
 	}
 protected:
+	int helloLapNo_;
 	boost::asio::streambuf* streambuf_ptr_;
 	std::ostream* os_ptr;
 	boost::archive::text_oarchive* ar_ptr;
 	size_t header_;
 	void asyn_sendMessage(MessageData & msg)
 	{
+		if (msg.isCommandMessage(Command::ClientSendInfoToServer)) {
+			msg.mLapNo = helloLapNo_;
+		}
+		if (getWireFormat() == WireFormat::wireFormatBinary) {
+			//gather the header and the rows of the frame, which is shared and immutable,
+			//the message and its header live until the write has completed
+			boost::shared_ptr<wire_send_state> state(new wire_send_state(msg));
+			const WireCodec codec = (WireCodec)codecAccepted_.load();
+			const bool hello = msg.isCommandMessage(Command::ClientSendInfoToServer);
+			if (hello) {
+				//offer a codec, sending stays raw until the receiver accepted it
+				state->header.codec = getWireCodec();
+				state->header.quality = getWireCodecQuality();
+				quality_.setMaximum(state->header.quality);
+			}
+			else if (codec != WireCodec::wireCodecRaw
+					&& encodeWirePayload(state->msg, codec, quality_.quality(), state->encoded)) {
+				state->header.codec = codec;
+				state->header.quality = quality_.quality();
+				state->header.payloadSize = state->encoded.size();
+			}
+			std::vector<boost::asio::const_buffer> buffers;
+			buffers.push_back(boost::asio::buffer(&state->header, sizeof(state->header)));
+			const cv::Mat& image = state->msg.mImg;
+			if (state->header.payloadSize > 0 && state->header.codec != WireCodec::wireCodecRaw) {
+				buffers.push_back(boost::asio::buffer(state->encoded));
+			}
+			else if (state->header.payloadSize > 0 && image.isContinuous()) {
+				buffers.push_back(boost::asio::buffer(image.data, state->header.payloadSize));
+			}
+			else if (state->header.payloadSize > 0) {
+				for (int row = 0; row < image.rows; row++) {
+					buffers.push_back(boost::asio::buffer(image.ptr(row), state->header.step));
+				}
+			}
+			printing("body is " + utilities::NumberToString(sizeof(state->header) + state->header.payloadSize) + " bytes" );
+			if (state->header.payloadSize > 0) {
+				writesPending_++;
+			}
+			strand_.post(boost::bind(&client::start_write_wire, this, buffers, state, hello));
+			return;
+		}
+
 		//init variables.
 		//		if (streambuf_ptr_) delete streambuf_ptr_;
 		//		if (os_ptr) delete os_ptr;
@@ -398,7 +596,7 @@ protected:
 
 		*ar_ptr << msg;
 
-		size_t header_ = streambuf_ptr_->size();
+		header_ = streambuf_ptr_->size();
 		printing("body is " + utilities::NumberToString(header_) + " bytes" );
 
 		// send header_ and buffer using scatter
@@ -408,18 +606,108 @@ protected:
 		if (sizeof(header_) == 4) // in case 32 bits, add more 4 bits to align with 64bits system
 		{
 			//printing("write more 4 bytes" );
-			unsigned int a = 0;
+			//outlives the write, which starts on strand_ after this returns
+			static const unsigned int a = 0;
 			buffers_.push_back(boost::asio::buffer(&a, sizeof(a)));
 		}
 		//--------------------------------------------------------------------------------------
 		buffers_.push_back( streambuf_ptr_->data() );
 
+		strand_.post(boost::bind(&client::start_write, this, buffers_));
+
+
+	}
+
+	struct wire_send_state {
+		MessageData msg;
+		WireHeader header;
+		std::vector<uchar> encoded;
+		boost::posix_time::ptime timeStarted;
+		explicit wire_send_state(const MessageData& source)
+		: msg(source), header(makeWireHeader(source)), timeStarted(boost::posix_time::microsec_clock::local_time()) {}
+	};
+
+	//negotiated codec, JPEG quality following the time writes take and the frame writes of this connection still pending
+	std::atomic<int> codecAccepted_;
+	wire_quality_controller quality_;
+	std::atomic<int> writesPending_;
+
+	//holds the message until here
+	void handle_write_wire(const boost::system::error_code& error, boost::shared_ptr<wire_send_state> state)
+	{
+		if (state->header.payloadSize > 0) {
+			const int writesPending = --writesPending_;
+			if (!error) {
+				const double milliseconds = (boost::posix_time::microsec_clock::local_time() - state->timeStarted).total_microseconds() / 1000.0;
+				//frames skipped by the overflow policy of GloQueueData say nothing about the link, leave them out
+				quality_.update(milliseconds, writesPending);
+			}
+		}
+		handle_write(error);
+	}
+
+	//on strand_, called from the sender thread via asyn_sendMessage()
+	void start_write(std::vector<boost::asio::const_buffer> buffers)
+	{
 		boost::asio::async_write(socket_,
-				buffers_,
-				boost::bind(&client::handle_write, this,
-						boost::asio::placeholders::error));
+				buffers,
+				strand_.wrap(boost::bind(&client::handle_write, this,
+						boost::asio::placeholders::error)));
+	}
 
+	//on strand_ as well, the hello starts reading the reply before it is written
+	void start_write_wire(std::vector<boost::asio::const_buffer> buffers, boost::shared_ptr<wire_send_state> state, bool hello)
+	{
+		if (hello) {
+			this->asyn_getReply();
+		}
+		boost::asio::async_write(socket_,
+				buffers,
+				strand_.wrap(boost::bind(&client::handle_write_wire, this,
+						boost::asio::placeholders::error, state)));
+	}
+
+	//answer to the hello message, only sent by receivers that know codecs
+	WireHeader replyHeader_;
+	std::vector<char> replyExtra_;
+	std::vector<boost::asio::mutable_buffer> replyBuffers_;
+
+	void asyn_getReply()
+	{
+		replyHeader_.codec = WireCodec::wireCodecRaw;
+		boost::asio::async_read(socket_, boost::asio::buffer(&replyHeader_, wireHeaderSizeV1),
+				strand_.wrap(boost::bind(&client::handle_read_reply_header, this,
+						boost::asio::placeholders::error)));
+	}
+
+	void handle_read_reply_header(const boost::system::error_code& error)
+	{
+		if (error || !isWireHeader(&replyHeader_) || replyHeader_.headerSize < wireHeaderSizeV1 || replyHeader_.headerSize > 4096) {
+			printing("no codec reply, sending raw frames");
+			return;
+		}
+		replyBuffers_.clear();
+		const size_t tail = wireHeaderTail(replyHeader_);
+		if (tail > 0) {
+			replyBuffers_.push_back(boost::asio::buffer(reinterpret_cast<char*>(&replyHeader_) + wireHeaderSizeV1, tail));
+		}
+		replyExtra_.resize(wireHeaderExtra(replyHeader_));
+		if (!replyExtra_.empty()) {
+			replyBuffers_.push_back(boost::asio::buffer(replyExtra_));
+		}
+		boost::asio::async_read(socket_, replyBuffers_,
+				strand_.wrap(boost::bind(&client::handle_read_reply, this,
+						boost::asio::placeholders::error)));
+	}
 
+	void handle_read_reply(const boost::system::error_code& error)
+	{
+		if (error) {
+			printing("no codec reply, sending raw frames");
+			return;
+		}
+		codecAccepted_.store(acceptWireCodec(replyHeader_.codec));
+		printing("codec negotiated: " + utilities::NumberToString(codecAccepted_.load()));
 	}
 
 	void handle_write(const boost::system::error_code& error)
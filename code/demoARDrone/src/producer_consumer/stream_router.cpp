@@ -0,0 +1,67 @@
+/*
+ * stream_router.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "stream_router.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+//queues align their indices to cache lines, which new does not guarantee before C++17
+static mpsc_queue<MessageData>* newQueue(size_t capacity, overflow_policy policy) {
+	void* memory = NULL;
+	if (posix_memalign(&memory, 64, sizeof(mpsc_queue<MessageData>)) != 0) {
+		throw std::bad_alloc();
+	}
+	return new (memory) mpsc_queue<MessageData>(capacity, policy);
+}
+
+static void deleteQueue(mpsc_queue<MessageData>* queue) {
+	queue->~mpsc_queue<MessageData>();
+	std::free(queue);
+}
+
+const size_t stream_router::maxStreams;
+
+stream_router::stream_router(size_t streams, size_t capacity, overflow_policy policy)
+: rejected_(0)
+{
+	streams = std::max<size_t>(1, std::min(streams, maxStreams));
+	for (size_t i = 0; i < streams; i++) {
+		queues_.push_back(boost::shared_ptr<mpsc_queue<MessageData> >(newQueue(capacity, policy), &deleteQueue));
+		routed_.push_back(boost::shared_ptr<std::atomic<size_t> >(new std::atomic<size_t>(0)));
+	}
+	sinks_.resize(streams);
+}
+
+void stream_router::setSink(size_t stream, const sink_function& sink) {
+	if (stream < sinks_.size()) {
+		sinks_[stream] = sink;
+	}
+}
+
+bool stream_router::route(size_t stream, MessageData& msg) {
+	if (stream >= queues_.size()) {
+		rejected_++;
+		return false;
+	}
+	(*routed_[stream])++;
+	if (sinks_[stream]) {
+		sinks_[stream](msg);
+	}
+	else {
+		queues_[stream]->push(std::move(msg));
+	}
+	return true;
+}
+
+void stream_router::sinkToQueueData(MessageData& msg) {
+	GloQueueData.push(std::move(msg));
+}
+
+void stream_router::sinkToQueueCommand(MessageData& msg) {
+	GloQueueCommand.push(std::move(msg));
+}
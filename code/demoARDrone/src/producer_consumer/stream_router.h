@@ -0,0 +1,67 @@
+/*
+ * stream_router.h
+ *
+ *  Hands messages received by the network sessions to the queue of their
+ *  stream, so one server can take the streams of several drones.
+ *  A session learns its stream ID from the mLapNo of a binary hello of
+ *  version 2 or later. Older builds leave an arbitrary lap number there, so
+ *  their hellos, and all text hellos, get the server's default stream, as
+ *  does a hello naming a stream the router does not have.
+ *  Each stream has its own bounded queue, or a sink set at setup time that
+ *  forwards it elsewhere, e.g. into GloQueueData or GloQueueCommand.
+ *  route() may be called from any thread of the io_service pool, sinks are
+ *  set before the io_service runs.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef STREAM_ROUTER_H_
+#define STREAM_ROUTER_H_
+
+#include <atomic>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "base/base_services.h"
+
+class stream_router {
+public:
+	//drones one process is meant to handle
+	static const size_t maxStreams = 8;
+
+	typedef boost::function<void(MessageData&)> sink_function;
+
+	//capacity and policy of each stream's own queue, see lockfree_queue.h
+	explicit stream_router(size_t streams,
+			size_t capacity = 16,
+			overflow_policy policy = overflow_policy::drop_oldest);
+
+	size_t streams() const { return queues_.size(); }
+
+	//forward a stream to sink instead of its queue
+	void setSink(size_t stream, const sink_function& sink);
+
+	//queue of a stream, for its consumer
+	mpsc_queue<MessageData>& queue(size_t stream) { return *queues_[stream]; }
+
+	//return false if there is no such stream
+	bool route(size_t stream, MessageData& msg);
+
+	//statistics since construction
+	size_t routed(size_t stream) const { return routed_[stream]->load(); }
+	size_t rejected() const { return rejected_.load(); }
+
+	//sinks into the global queues, for the single drone setup
+	static void sinkToQueueData(MessageData& msg);
+	static void sinkToQueueCommand(MessageData& msg);
+
+protected:
+	std::vector<boost::shared_ptr<mpsc_queue<MessageData> > > queues_;
+	std::vector<sink_function> sinks_;
+	std::vector<boost::shared_ptr<std::atomic<size_t> > > routed_;
+	std::atomic<size_t> rejected_;
+};
+
+#endif /* STREAM_ROUTER_H_ */
@@ -0,0 +1,394 @@
+/*
+ * udp_transport.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "udp_transport.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+bool GloUdpFrames = false;
+boost::mutex mt_protectUdpFrames;
+bool getUdpFrames() {
+	boost::mutex::scoped_lock lock(mt_protectUdpFrames);
+	return GloUdpFrames;
+}
+void setUdpFrames(bool udp) {
+	boost::mutex::scoped_lock lock(mt_protectUdpFrames);
+	GloUdpFrames = udp;
+}
+
+//largest frame a receiver reassembles, well above a raw 1280x720 BGR image
+static const size_t udpMaxFrameSize = 16 << 20;
+
+//whether sequence a comes before b, across the wrap around
+static bool sequenceBefore(uint32_t a, uint32_t b) {
+	return (int32_t)(a - b) < 0;
+}
+
+//---------------------------------------------------------------------------
+//udp_frame_sender
+
+udp_frame_sender::udp_frame_sender(boost::asio::io_service& io_service,
+		const std::string& hostDst, const std::string& portDst,
+		size_t maxDatagram)
+: lossForTesting(0.0),
+  socket_(io_service, udp::endpoint(udp::v4(), 0)),
+  maxDatagram_(std::max(maxDatagram, sizeof(UdpFragmentHeader) + 64)),
+  session_(std::random_device()()),
+  sequence_(0),
+  framesSent_(0),
+  fragmentsSent_(0)
+{
+	udp::resolver resolver(io_service);
+	udp::resolver::query query(udp::v4(), hostDst, portDst);
+	endpoint_ = *resolver.resolve(query);
+	socket_.set_option(udp::socket::send_buffer_size(4 << 20));
+}
+
+bool udp_frame_sender::send(const MessageData& msg) {
+	WireHeader header = makeWireHeader(msg);
+
+	//the payload is sent from the image itself if its rows are packed, else from a copy
+	const char* payload = reinterpret_cast<const char*>(msg.mImg.data);
+	const WireCodec codec = getWireCodec();
+	if (header.payloadSize > 0 && codec != WireCodec::wireCodecRaw
+			&& encodeWirePayload(msg, codec, getWireCodecQuality(), encoded_)) {
+		header.codec = codec;
+		header.quality = getWireCodecQuality();
+		header.payloadSize = encoded_.size();
+		payload = reinterpret_cast<const char*>(&encoded_[0]);
+	}
+	else if (header.payloadSize > 0 && !msg.mImg.isContinuous()) {
+		writeWireMessage(msg, packed_);
+		payload = &packed_[sizeof(WireHeader)];
+	}
+
+	const size_t frameSize = sizeof(WireHeader) + header.payloadSize;
+	const size_t fragmentSize = maxDatagram_ - sizeof(UdpFragmentHeader);
+	const size_t fragmentCount = (frameSize + fragmentSize - 1) / fragmentSize;
+	if (frameSize > udpMaxFrameSize || fragmentCount > 0xffff) {
+		printing("[ERROR] udp_frame_sender: frame of " + utilities::NumberToString((int)frameSize) + " bytes too large");
+		return false;
+	}
+
+	UdpFragmentHeader fragment;
+	fragment.magic = UdpFragmentHeader::magicNumber;
+	fragment.session = session_;
+	fragment.sequence = sequence_++;
+	fragment.fragmentCount = (uint16_t)fragmentCount;
+	fragment.frameSize = (uint32_t)frameSize;
+
+	std::vector<boost::asio::const_buffer> buffers;
+	for (size_t i = 0; i < fragmentCount; i++) {
+		const size_t begin = i * fragmentSize;
+		const size_t end = std::min(frameSize, begin + fragmentSize);
+		fragment.fragmentIndex = (uint16_t)i;
+		fragment.offset = (uint32_t)begin;
+		if (lossForTesting > 0.0 && std::rand() < lossForTesting * RAND_MAX) {
+			continue;
+		}
+
+		//a fragment may span the end of the header and the start of the payload
+		buffers.clear();
+		buffers.push_back(boost::asio::buffer(&fragment, sizeof(fragment)));
+		if (begin < sizeof(WireHeader)) {
+			const size_t headerEnd = std::min(end, sizeof(WireHeader));
+			buffers.push_back(boost::asio::buffer(reinterpret_cast<const char*>(&header) + begin, headerEnd - begin));
+		}
+		if (end > sizeof(WireHeader)) {
+			const size_t payloadBegin = std::max(begin, sizeof(WireHeader)) - sizeof(WireHeader);
+			buffers.push_back(boost::asio::buffer(payload + payloadBegin, end - sizeof(WireHeader) - payloadBegin));
+		}
+
+		boost::system::error_code error;
+		socket_.send_to(buffers, endpoint_, 0, error);
+		if (error) {
+			printing("[ERROR] udp_frame_sender: " + error.message());
+			return false;
+		}
+		fragmentsSent_++;
+	}
+	framesSent_++;
+	return true;
+}
+
+void udp_frame_sender::process_sender() {
+	printing("udp_frame_sender::process_sender");
+	MessageData msg;
+	while (true) {
+		GloQueueData.wait_and_pop(msg);
+		this->send(msg);
+	}
+}
+
+//---------------------------------------------------------------------------
+//udp_frame_receiver
+
+udp_frame_receiver::udp_frame_receiver(boost::asio::io_service& io_service,
+		unsigned short port,
+		deliver_function deliver,
+		boost::posix_time::time_duration timeout,
+		size_t maxPendingFrames)
+: socket_(io_service, udp::endpoint(udp::v4(), port)),
+  datagram_(65536),
+  deliver_(deliver),
+  timeout_(timeout),
+  maxPendingFrames_(std::max<size_t>(maxPendingFrames, 1)),
+  anySession_(false),
+  session_(0),
+  previousSession_(0),
+  anyCompleted_(false),
+  lastCompleted_(0),
+  framesDelivered_(new std::atomic<size_t>(0)),
+  framesIncomplete_(0),
+  fragmentsInvalid_(0),
+  fragmentsLate_(0)
+{
+	//room for a few frames arriving in a burst
+	socket_.set_option(udp::socket::receive_buffer_size(4 << 20));
+	asyn_receive();
+}
+
+void udp_frame_receiver::pushToQueue(MessageData& msg) {
+	GloQueueData.push(std::move(msg));
+}
+
+void udp_frame_receiver::asyn_receive() {
+	socket_.async_receive_from(boost::asio::buffer(datagram_), endpointSrc_,
+			boost::bind(&udp_frame_receiver::handle_receive, this,
+					boost::asio::placeholders::error,
+					boost::asio::placeholders::bytes_transferred));
+}
+
+void udp_frame_receiver::handle_receive(const boost::system::error_code& error, size_t bytes_transferred) {
+	if (error == boost::asio::error::operation_aborted) {
+		return;
+	}
+	if (!error) {
+		UdpFragmentHeader fragment;
+		if (bytes_transferred >= sizeof(fragment)) {
+			std::memcpy(&fragment, &datagram_[0], sizeof(fragment));
+		}
+		if (bytes_transferred < sizeof(fragment) || fragment.magic != UdpFragmentHeader::magicNumber
+				|| !add_fragment(fragment, &datagram_[sizeof(fragment)], bytes_transferred - sizeof(fragment))) {
+			fragmentsInvalid_++;
+		}
+		discard_stale(boost::posix_time::microsec_clock::local_time());
+	}
+	else {
+		//e.g. ICMP port unreachable reported for an earlier datagram, the socket is still usable
+		printing("[ERROR] udp_frame_receiver: " + error.message());
+	}
+	asyn_receive();
+}
+
+bool udp_frame_receiver::add_fragment(const UdpFragmentHeader& fragment, const char* data, size_t size) {
+	if (fragment.fragmentCount == 0 || fragment.fragmentIndex >= fragment.fragmentCount
+			|| fragment.frameSize < sizeof(WireHeader) || fragment.frameSize > udpMaxFrameSize
+			|| size == 0 || fragment.offset > fragment.frameSize || size > fragment.frameSize - fragment.offset) {
+		return false;
+	}
+	if (!anySession_ || fragment.session != session_) {
+		if (anySession_ && fragment.session == previousSession_) {
+			//sent by the old session before the restart, but reordered behind the new one
+			fragmentsLate_++;
+			return true;
+		}
+		restart(fragment.session);
+	}
+	if (anyCompleted_ && !sequenceBefore(lastCompleted_, fragment.sequence)) {
+		//the frame is complete already, or discarded because a newer one is
+		fragmentsLate_++;
+		return true;
+	}
+
+	std::map<uint32_t, reassembly>::iterator it = frames_.find(fragment.sequence);
+	if (it == frames_.end()) {
+		if (frames_.size() >= maxPendingFrames_) {
+			discard(frames_.begin());
+		}
+		reassembly& frame = frames_[fragment.sequence];
+		if (!spareBuffers_.empty()) {
+			frame.data.swap(spareBuffers_.back());
+			spareBuffers_.pop_back();
+		}
+		frame.data.resize(fragment.frameSize);
+		frame.received.assign(fragment.fragmentCount, false);
+		frame.fragmentsReceived = 0;
+		frame.started = boost::posix_time::microsec_clock::local_time();
+		it = frames_.find(fragment.sequence);
+	}
+	reassembly& frame = it->second;
+	if (frame.data.size() != fragment.frameSize || frame.received.size() != fragment.fragmentCount) {
+		return false;
+	}
+	if (frame.received[fragment.fragmentIndex]) {
+		return true;
+	}
+	std::memcpy(&frame.data[fragment.offset], data, size);
+	frame.received[fragment.fragmentIndex] = true;
+	frame.fragmentsReceived++;
+	if (frame.fragmentsReceived < frame.received.size()) {
+		return true;
+	}
+
+	//older frames still missing fragments will not be shown after this one
+	while (frames_.begin()->first != fragment.sequence && sequenceBefore(frames_.begin()->first, fragment.sequence)) {
+		discard(frames_.begin());
+	}
+	anyCompleted_ = true;
+	lastCompleted_ = fragment.sequence;
+	complete(frame);
+	release(frames_.find(fragment.sequence));
+	return true;
+}
+
+void udp_frame_receiver::complete(reassembly& frame) {
+	WireHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(&header, &frame.data[0], wireHeaderSizeV1);
+	header.codec = WireCodec::wireCodecRaw;
+	if (header.headerSize >= wireHeaderSizeV1 && header.headerSize <= frame.data.size()) {
+		std::memcpy(reinterpret_cast<char*>(&header) + wireHeaderSizeV1, &frame.data[wireHeaderSizeV1], wireHeaderTail(header));
+	}
+	std::string error;
+	if (!checkWireHeader(header, error)) {
+		printing("[ERROR] udp_frame_receiver: " + error);
+		return;
+	}
+	if (header.headerSize + header.payloadSize != frame.data.size()) {
+		printing("[ERROR] udp_frame_receiver: frame size does not match the header");
+		return;
+	}
+
+	MessageData msg;
+	applyWireHeader(header, msg, GloFramePool);
+	const char* payload = &frame.data[header.headerSize];
+	if (header.payloadSize == 0 || header.codec == WireCodec::wireCodecRaw) {
+		readWirePayload(header, payload, msg);
+		(*framesDelivered_)++;
+		deliver_(msg);
+		return;
+	}
+
+	//decode off the io_service thread: the job takes the reassembly buffer, release() finds it empty
+	boost::shared_ptr<std::vector<char> > data(new std::vector<char>());
+	data->swap(frame.data);
+	deliver_function deliver = deliver_;
+	boost::shared_ptr<std::atomic<size_t> > delivered = framesDelivered_;
+	codec_worker::instance().post([header, data, msg, deliver, delivered]() mutable {
+		const cv::Mat encoded(1, (int)header.payloadSize, CV_8UC1, &(*data)[header.headerSize]);
+		if (!decodeWirePayload(header, encoded, msg)) {
+			printing("[ERROR] udp_frame_receiver: payload does not match the header, frame dropped");
+			return;
+		}
+		(*delivered)++;
+		deliver(msg);
+	});
+}
+
+void udp_frame_receiver::restart(uint32_t session) {
+	if (anySession_) {
+		printing("udp_frame_receiver: sender restarted, " + utilities::NumberToString((int)frames_.size()) + " frames of the old one discarded");
+		previousSession_ = session_;
+	}
+	while (!frames_.empty()) {
+		discard(frames_.begin());
+	}
+	anySession_ = true;
+	session_ = session;
+	anyCompleted_ = false;
+}
+
+void udp_frame_receiver::release(std::map<uint32_t, reassembly>::iterator frame) {
+	if (spareBuffers_.size() < maxPendingFrames_) {
+		spareBuffers_.push_back(std::vector<char>());
+		spareBuffers_.back().swap(frame->second.data);
+	}
+	frames_.erase(frame);
+}
+
+void udp_frame_receiver::discard(std::map<uint32_t, reassembly>::iterator frame) {
+	release(frame);
+	framesIncomplete_++;
+}
+
+void udp_frame_receiver::discard_stale(const boost::posix_time::ptime& now) {
+	for (std::map<uint32_t, reassembly>::iterator it = frames_.begin(); it != frames_.end(); ) {
+		if (now - it->second.started > timeout_) {
+			discard(it++);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+
+void udpLoopbackTest(unsigned short port, int frames, double lossPercent) {
+	boost::asio::io_service io_service;
+
+	//every pixel of frame i is i % 256, checked on arrival
+	std::atomic<int> received(0);
+	std::atomic<int> corrupted(0);
+	udp_frame_receiver receiver(io_service, port, [&received, &corrupted](MessageData& msg) {
+		const uchar expected = (uchar)(msg.mLapNo % 256);
+		bool intact = msg.mImg.rows == 360 && msg.mImg.cols == 640;
+		for (int row = 0; row < msg.mImg.rows && intact; row++) {
+			const uchar* pixels = msg.mImg.ptr(row);
+			for (size_t i = 0; i < msg.mImg.cols * msg.mImg.elemSize(); i++) {
+				intact = intact && pixels[i] == expected;
+			}
+		}
+		if (!intact) {
+			corrupted++;
+		}
+		received++;
+	});
+	boost::thread t_receiver = boost::thread([&io_service]() { io_service.run(); });
+
+	//the second sender stands in for the first one restarted, numbering its frames from 0 again
+	std::vector<int> receivedPerSession;
+	size_t fragmentsSent = 0;
+	for (int session = 0; session < 2; session++) {
+		const int receivedBefore = received.load();
+		udp_frame_sender sender(io_service, "127.0.0.1", utilities::NumberToString(port));
+		sender.lossForTesting = lossPercent / 100.0;
+		for (int i = 0; i < frames; i++) {
+			MessageData msg = MessageData::createMessage(Command::ClientSendInfoToServer);
+			msg.mLapNo = i;
+			msg.mTimeStamp = boost::posix_time::microsec_clock::local_time();
+			msg.mImg = GloFramePool.acquire(cv::Size(640, 360), CV_8UC3);
+			msg.mImg.setTo(cv::Scalar(i % 256, i % 256, i % 256));
+			sender.send(msg);
+			boost::this_thread::sleep(boost::posix_time::milliseconds(33));
+		}
+		//let the last frames of this session arrive before the next one starts
+		boost::this_thread::sleep(boost::posix_time::milliseconds(300));
+		receivedPerSession.push_back(received.load() - receivedBefore);
+		fragmentsSent += sender.fragmentsSent();
+	}
+
+	//let the last frames arrive or time out
+	boost::this_thread::sleep(boost::posix_time::milliseconds(500));
+	io_service.stop();
+	t_receiver.join();
+
+	printing("udp loopback: frames sent " + utilities::NumberToString(frames) + " per session"
+			+ ", fragments sent " + utilities::NumberToString((int)fragmentsSent)
+			+ ", frames received " + utilities::NumberToString(receivedPerSession[0])
+			+ " before and " + utilities::NumberToString(receivedPerSession[1]) + " after the sender restarted"
+			+ ", corrupted " + utilities::NumberToString(corrupted.load())
+			+ ", incomplete " + utilities::NumberToString((int)receiver.framesIncomplete())
+			+ ", late fragments " + utilities::NumberToString((int)receiver.fragmentsLate())
+			+ ", invalid fragments " + utilities::NumberToString((int)receiver.fragmentsInvalid()));
+}
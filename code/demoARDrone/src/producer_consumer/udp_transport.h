@@ -0,0 +1,151 @@
+/*
+ * udp_transport.h
+ *
+ *  Frames between the laptops over UDP, as an alternative to the TCP
+ *  sessions of sender_receiver.h: a lost packet then costs one frame
+ *  instead of stalling every frame queued behind it.
+ *  A frame is a binary wire message (wire_format.h), split into fragments
+ *  that fit into one datagram each. Every fragment carries the frame's
+ *  sequence number and its offset, the receiver reassembles frames and
+ *  discards those still incomplete after a timeout or once a newer frame
+ *  is complete. Each sender picks a random session number, so a restarted
+ *  sender, counting from sequence 0 again, is told apart from the old one.
+ *  Commands stay on the reliable TCP connection.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef UDP_TRANSPORT_H_
+#define UDP_TRANSPORT_H_
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "base/base_services.h"
+
+using boost::asio::ip::udp;
+
+//send frames over UDP instead of the TCP sessions, see "-udp" of "-dev"
+extern bool getUdpFrames();
+extern void setUdpFrames(bool);
+
+struct UdpFragmentHeader {
+	static const uint32_t magicNumber = 0x46555244; // "DRUF"
+
+	uint32_t magic;
+	uint32_t session;		// random per sender, changes when it restarts
+	uint32_t sequence;		// of the frame, wraps around
+	uint16_t fragmentIndex;
+	uint16_t fragmentCount;
+	uint32_t frameSize;		// bytes of the whole wire message
+	uint32_t offset;		// of this fragment within the wire message
+};
+
+static_assert(sizeof(UdpFragmentHeader) == 24, "UdpFragmentHeader must have the same layout on both laptops");
+
+//---------------------------------------------------------------------------
+class udp_frame_sender {
+public:
+	//maxDatagram: UDP payload per datagram, 1472 fits an Ethernet MTU of 1500 without IP fragmentation
+	udp_frame_sender(boost::asio::io_service& io_service,
+			const std::string& hostDst, const std::string& portDst,
+			size_t maxDatagram = 1472);
+
+	//send one frame, encoded with the codec set by setWireCodec(), blocking until every fragment is handed to the kernel
+	bool send(const MessageData& msg);
+
+	//send frames from GloQueueData forever, run in its own thread
+	void process_sender();
+
+	//drop this share of fragments instead of sending them, to test reassembly over loopback
+	double lossForTesting;
+
+	size_t framesSent() const { return framesSent_; }
+	size_t fragmentsSent() const { return fragmentsSent_; }
+
+protected:
+	udp::socket socket_;
+	udp::endpoint endpoint_;
+	size_t maxDatagram_;
+	uint32_t session_;
+	uint32_t sequence_;
+	std::vector<uchar> encoded_;
+	std::vector<char> packed_;
+	size_t framesSent_;
+	size_t fragmentsSent_;
+};
+
+//---------------------------------------------------------------------------
+class udp_frame_receiver {
+public:
+	typedef boost::function<void(MessageData&)> deliver_function;
+
+	//deliver: called with every complete frame, from the io_service thread or, for encoded frames, the codec worker
+	udp_frame_receiver(boost::asio::io_service& io_service,
+			unsigned short port,
+			deliver_function deliver,
+			boost::posix_time::time_duration timeout = boost::posix_time::milliseconds(200),
+			size_t maxPendingFrames = 4);
+
+	//statistics since construction
+	size_t framesDelivered() const { return framesDelivered_->load(); }
+	size_t framesIncomplete() const { return framesIncomplete_.load(); }
+	size_t fragmentsInvalid() const { return fragmentsInvalid_.load(); }
+	size_t fragmentsLate() const { return fragmentsLate_.load(); }
+
+	//delivery into GloQueueData
+	static void pushToQueue(MessageData& msg);
+
+protected:
+	struct reassembly {
+		std::vector<char> data;
+		std::vector<bool> received;
+		size_t fragmentsReceived;
+		boost::posix_time::ptime started;
+	};
+
+	void asyn_receive();
+	void handle_receive(const boost::system::error_code& error, size_t bytes_transferred);
+	bool add_fragment(const UdpFragmentHeader& fragment, const char* data, size_t size);
+	void complete(reassembly& frame);
+	//a new sender session, forget the frames of the old one
+	void restart(uint32_t session);
+	//drop a frame from frames_, keeping its buffer for the next one; discard() counts it as incomplete
+	void release(std::map<uint32_t, reassembly>::iterator frame);
+	void discard(std::map<uint32_t, reassembly>::iterator frame);
+	void discard_stale(const boost::posix_time::ptime& now);
+
+	udp::socket socket_;
+	udp::endpoint endpointSrc_;
+	std::vector<char> datagram_;
+	deliver_function deliver_;
+	boost::posix_time::time_duration timeout_;
+	size_t maxPendingFrames_;
+
+	std::map<uint32_t, reassembly> frames_;
+	std::vector<std::vector<char> > spareBuffers_;
+	bool anySession_;
+	uint32_t session_;
+	uint32_t previousSession_;
+	bool anyCompleted_;
+	uint32_t lastCompleted_;
+
+	//shared with the decoding jobs, which may outlive the receiver
+	boost::shared_ptr<std::atomic<size_t> > framesDelivered_;
+	std::atomic<size_t> framesIncomplete_;
+	std::atomic<size_t> fragmentsInvalid_;
+	std::atomic<size_t> fragmentsLate_;
+};
+
+//send synthetic frames to a receiver in the same process over 127.0.0.1 and report what arrived,
+//then restart the sender and check that the frames of the new one arrive as well
+void udpLoopbackTest(unsigned short port, int frames, double lossPercent);
+
+#endif /* UDP_TRANSPORT_H_ */
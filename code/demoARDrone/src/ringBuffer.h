@@ -0,0 +1,126 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// fixed-capacity ring buffer with running linearly weighted mean
+// ===============================================================
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <algorithm>
+
+// ring buffer of the latest "capacity" samples, each made of "lanes" values: Besides the plain sum, it keeps the sum
+//                                                                          weighted linearly by age - 1 for the oldest
+//                                                                          sample up to n for the newest of n - which
+//                                                                          "push()" updates in O(1): Dropping the
+//                                                                          oldest sample lowers every other weight by
+//                                                                          one, i.e. subtracts the plain sum.
+// user note: Pushing into a full buffer drops the oldest sample. Sums are kept in "double", so they stay exact for
+//            integral values such as pixel coordinates.
+template< typename Value, int capacity, int lanes = 1 >
+class RingBuffer {
+	
+	// c'tor, empty
+	public:
+	RingBuffer() { this->clear() ; }
+	
+	// samples: forget all, count, add one (dropping the oldest if full), access by age with 0 being the oldest
+	public:
+	void clear() {
+		this->first = 0 ;
+		this->count = 0 ;
+		std::fill( this->sums.plain,    this->sums.plain    + lanes, 0.0 ) ;
+		std::fill( this->sums.weighted, this->sums.weighted + lanes, 0.0 ) ;
+	}
+	bool empty() const { return this->count == 0 ; }
+	bool full()  const { return this->count == capacity ; }
+	int  size()  const { return this->count ; }
+	void push( const Value* sample ) {
+		if( this->full() ) {
+			const Value* const oldest = this->values[ this->first ] ;
+			for( int lane = 0 ; lane < lanes ; ++lane ) {
+				this->sums.weighted[ lane ] -= this->sums.plain[ lane ] ;
+				this->sums.plain[    lane ] -= oldest[ lane ] ;
+			}
+			this->first = ( this->first + 1 ) % capacity ;
+			--this->count ;
+		}
+		Value* const newest = this->values[ ( this->first + this->count ) % capacity ] ;
+		++this->count ;
+		for( int lane = 0 ; lane < lanes ; ++lane ) {
+			newest[ lane ] = sample[ lane ] ;
+			this->sums.plain[    lane ] += sample[ lane ] ;
+			this->sums.weighted[ lane ] += (double)this->count * sample[ lane ] ;
+		}
+	}
+	void push( const Value sample ) {
+		static_assert( lanes == 1, "Scalar push requires a single lane." ) ;
+		this->push( &sample ) ;
+	}
+	const Value* operator []( const int age ) const { return this->values[ ( this->first + age ) % capacity ] ; }
+	protected:
+	Value values[ capacity ][ lanes ] ;
+	int   first,
+	      count ;
+	
+	// plain and linearly weighted mean per lane, zero if empty
+	public:
+	double mean( const int lane = 0 ) const {
+		return this->empty() ? 0.0 : this->sums.plain[ lane ] / this->count ;
+	}
+	double weightedMean( const int lane = 0 ) const {
+		return this->empty() ? 0.0 : this->sums.weighted[ lane ] / ( 0.5 * this->count * ( this->count + 1 ) ) ;
+	}
+	
+	// running sums, next to each other so that one update touches as few cache lines as possible
+	// developer note: For four lanes, both arrays together take 64 bytes, i.e. one cache line if the owner is aligned
+	//                 accordingly. No "alignas()" though, as "new" in C++11 does not honor over-alignment.
+	protected:
+	struct Sums {
+		double plain[    lanes ],
+		       weighted[ lanes ] ;
+	} ;
+	Sums sums ;
+
+} ; // class "RingBuffer"
+
+// smoother of a box over its latest "capacity" observations: The four corner coordinates are the lanes of one ring
+//                                                            buffer, so their running sums share one cache line.
+template< int capacity >
+class BoxSmoother {
+	
+	// observations: forget all, count, add one
+	public:
+	void clear()       { this->corners.clear() ; }
+	bool empty() const { return this->corners.empty() ; }
+	bool full()  const { return this->corners.full() ; }
+	int  size()  const { return this->corners.size() ; }
+	void push( const cv::Rect box ) {
+		const int sample[ 4 ] = { box.x, box.y, box.x + box.width, box.y + box.height } ;
+		this->corners.push( sample ) ;
+	}
+	protected:
+	RingBuffer< int, capacity, 4 > corners ;
+	
+	// box from the linearly weighted means of the corners, newer observations weigh more
+	// developer note: Coordinates are truncated as by the integer queue used before.
+	public:
+	cv::Rect weightedMean() const {
+		return cv::Rect( cv::Point( (int)this->corners.weightedMean( 0 ), (int)this->corners.weightedMean( 1 ) ),
+		                 cv::Point( (int)this->corners.weightedMean( 2 ), (int)this->corners.weightedMean( 3 ) ) ) ;
+	}
+
+} ; // class "BoxSmoother"
@@ -0,0 +1,126 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// minimal SIMD abstraction for float arrays
+// ==========================================
+
+#pragma once
+
+#include <cmath>
+#if defined( __AVX__ )
+	#include <immintrin.h>
+#elif defined( __SSE2__ )
+	#include <emmintrin.h>
+#endif
+
+// "Vec" holds "lanes" floats: AVX, SSE2 or scalar, depending on the compiler target
+// user note: Loads and stores must be aligned to the vector size. "vWithin()" is 1 for lanes within [lo,hi), else 0.
+namespace simd {
+
+#if defined( __AVX__ )
+typedef __m256 Vec ;
+const int lanes = 8 ;
+inline Vec   vLoad(  const float* ptr )                { return _mm256_load_ps( ptr ) ; }
+inline void  vStore(       float* ptr, const Vec v )   {        _mm256_store_ps( ptr, v ) ; }
+inline Vec   vSet(   const float  s )                  { return _mm256_set1_ps( s ) ; }
+inline Vec   vAdd(   const Vec    a,   const Vec b )   { return _mm256_add_ps( a, b ) ; }
+inline Vec   vSub(   const Vec    a,   const Vec b )   { return _mm256_sub_ps( a, b ) ; }
+inline Vec   vMul(   const Vec    a,   const Vec b )   { return _mm256_mul_ps( a, b ) ; }
+inline Vec   vMin(   const Vec    a,   const Vec b )   { return _mm256_min_ps( a, b ) ; }
+inline Vec   vMax(   const Vec    a,   const Vec b )   { return _mm256_max_ps( a, b ) ; }
+inline Vec   vWithin( const Vec    v,   const Vec lo, const Vec hi ) {
+	return _mm256_and_ps( _mm256_and_ps( _mm256_cmp_ps( v, lo, _CMP_GE_OQ ), _mm256_cmp_ps( v, hi, _CMP_LT_OQ ) ), vSet( 1.0f ) ) ;
+}
+inline float vSum(   const Vec    v ) {
+	__m128 s = _mm_add_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) ) ;
+	s = _mm_add_ps( s, _mm_movehl_ps( s, s ) ) ;
+	s = _mm_add_ss( s, _mm_shuffle_ps( s, s, 1 ) ) ;
+	return _mm_cvtss_f32( s ) ;
+}
+#elif defined( __SSE2__ )
+typedef __m128 Vec ;
+const int lanes = 4 ;
+inline Vec   vLoad(  const float* ptr )                { return _mm_load_ps( ptr ) ; }
+inline void  vStore(       float* ptr, const Vec v )   {        _mm_store_ps( ptr, v ) ; }
+inline Vec   vSet(   const float  s )                  { return _mm_set1_ps( s ) ; }
+inline Vec   vAdd(   const Vec    a,   const Vec b )   { return _mm_add_ps( a, b ) ; }
+inline Vec   vSub(   const Vec    a,   const Vec b )   { return _mm_sub_ps( a, b ) ; }
+inline Vec   vMul(   const Vec    a,   const Vec b )   { return _mm_mul_ps( a, b ) ; }
+inline Vec   vMin(   const Vec    a,   const Vec b )   { return _mm_min_ps( a, b ) ; }
+inline Vec   vMax(   const Vec    a,   const Vec b )   { return _mm_max_ps( a, b ) ; }
+inline Vec   vWithin( const Vec    v,   const Vec lo, const Vec hi ) {
+	return _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( v, lo ), _mm_cmplt_ps( v, hi ) ), vSet( 1.0f ) ) ;
+}
+inline float vSum(   const Vec    v ) {
+	__m128 s = _mm_add_ps( v, _mm_movehl_ps( v, v ) ) ;
+	s = _mm_add_ss( s, _mm_shuffle_ps( s, s, 1 ) ) ;
+	return _mm_cvtss_f32( s ) ;
+}
+#else
+typedef float Vec ;
+const int lanes = 1 ;
+inline Vec   vLoad(  const float* ptr )                { return *ptr ; }
+inline void  vStore(       float* ptr, const Vec v )   { *ptr = v ; }
+inline Vec   vSet(   const float  s )                  { return s ; }
+inline Vec   vAdd(   const Vec    a,   const Vec b )   { return a + b ; }
+inline Vec   vSub(   const Vec    a,   const Vec b )   { return a - b ; }
+inline Vec   vMul(   const Vec    a,   const Vec b )   { return a * b ; }
+inline Vec   vMin(   const Vec    a,   const Vec b )   { return a < b ? a : b ; }
+inline Vec   vMax(   const Vec    a,   const Vec b )   { return a > b ? a : b ; }
+inline Vec   vWithin( const Vec    v,   const Vec lo, const Vec hi ) {
+	return ( v >= lo && v < hi ) ? 1.0f : 0.0f ;
+}
+inline float vSum(   const Vec    v )                  { return v ; }
+#endif
+
+// lane-wise "exp()" via range reduction to [-ln(2)/2,ln(2)/2] and a degree 5 polynomial (as in Cephes' "expf()"),
+// relative error about 2e-7 within [-87,88]
+// developer note: AVX lacks 256 bit integer shifts, so the exponent is assembled from two SSE2 halves.
+#if defined( __SSE2__ )
+inline __m128i vExpPow2( const __m128i n ) {
+	return _mm_slli_epi32( _mm_add_epi32( n, _mm_set1_epi32( 127 ) ), 23 ) ;
+}
+#endif
+inline Vec vExp( Vec x ) {
+	#if defined( __AVX__ ) || defined( __SSE2__ )
+	x = vMin( vMax( x, vSet( -87.0f ) ), vSet( 88.0f ) ) ;
+	#if defined( __AVX__ )
+	const Vec     n   = _mm256_floor_ps( vAdd( vMul( x, vSet( 1.44269504088896341f ) ), vSet( 0.5f ) ) ) ;
+	const __m256i nI  = _mm256_cvttps_epi32( n ) ;
+	const Vec     pow = _mm256_castsi256_ps( _mm256_insertf128_si256(
+	                        _mm256_castsi128_si256( vExpPow2( _mm256_castsi256_si128( nI ) ) ),
+	                        vExpPow2( _mm256_extractf128_si256( nI, 1 ) ), 1 ) ) ;
+	#else
+	const Vec     nR  = vAdd( vMul( x, vSet( 1.44269504088896341f ) ), vSet( 0.5f ) ) ;
+	const Vec     nT  = _mm_cvtepi32_ps( _mm_cvttps_epi32( nR ) ) ;
+	const Vec     n   = vSub( nT, _mm_and_ps( _mm_cmpgt_ps( nT, nR ), vSet( 1.0f ) ) ) ;
+	const Vec     pow = _mm_castsi128_ps( vExpPow2( _mm_cvttps_epi32( n ) ) ) ;
+	#endif
+	x = vSub( vSub( x, vMul( n, vSet( 0.693359375f ) ) ), vMul( n, vSet( -2.12194440e-4f ) ) ) ;
+	Vec y = vSet( 1.9875691500e-4f ) ;
+	y = vAdd( vMul( y, x ), vSet( 1.3981999507e-3f ) ) ;
+	y = vAdd( vMul( y, x ), vSet( 8.3334519073e-3f ) ) ;
+	y = vAdd( vMul( y, x ), vSet( 4.1665795894e-2f ) ) ;
+	y = vAdd( vMul( y, x ), vSet( 1.6666665459e-1f ) ) ;
+	y = vAdd( vMul( y, x ), vSet( 5.0000001201e-1f ) ) ;
+	y = vAdd( vAdd( vMul( vMul( y, x ), x ), x ), vSet( 1.0f ) ) ;
+	return vMul( y, pow ) ;
+	#else
+	return std::exp( x ) ;
+	#endif
+}
+
+} // namespace "simd"
@@ -22,6 +22,7 @@
 
 #include "sparse3D2.h"
 #include "odometryDrone.h"
+#include "visualSink.h"
 #include "hawaii/GPU/autoMat.h"
 #include "hawaii/common/helpers.h"
 #include "hawaii/common/error.h"
@@ -597,7 +598,7 @@ void Sparse3D2::visualize( cv::Mat& visualization ) const {
 		                        255 * ( 0.0 + this->trackerForwardSpeed ) ),
 		            4                                                       ) ;
 		
-		cv::imshow("visualize3DPos", visualize3DPos);
+		VISUAL_SHOW( visualize3DPos ) ;
 
 		boost::posix_time::ptime current_time = boost::posix_time::microsec_clock::local_time();
 		boost::posix_time::time_duration diff = current_time - Glostart_time;
@@ -0,0 +1,170 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// visualization on its own thread at a capped rate
+// =================================================
+
+#include "visualSink.h"
+#include "hawaii/common/error.h"
+#include <opencv2/highgui/highgui.hpp>
+#include <algorithm>
+
+// the single instance, created on first use
+VisualSink& VisualSink::instance() {
+	static VisualSink sink ;
+	return sink ;
+}
+
+// c'tor, the render thread is started with the first image
+VisualSink::VisualSink() :
+	headlessFlag( false ),
+	rate( 15.0 ),
+	stopping( false ) {
+}
+
+// d'tor, stop and join the render thread
+VisualSink::~VisualSink() {
+	{
+		boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+		this->stopping = true ;
+	}
+	this->keyPressed.notify_all() ;
+	if( this->renderThread.joinable() ) {
+		this->renderThread.join() ;
+	}
+}
+
+// settings
+void VisualSink::setHeadless( const bool headlessArg ) {
+	boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+	HAWAII_ERROR_CONDITIONAL( this->renderThread.joinable() && headlessArg,
+	                          "Headless mode must be set before the first image is shown." ) ;
+	this->headlessFlag = headlessArg ;
+}
+bool VisualSink::headless() const {
+	boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+	return this->headlessFlag ;
+}
+void VisualSink::setRate( const double rateArg ) {
+	HAWAII_ERROR_CONDITIONAL( rateArg <= 0.0,
+	                          "Rate must be positive." ) ;
+	boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+	this->rate = rateArg ;
+}
+
+// publish the latest image of a window
+void VisualSink::show( const std::string& name,
+                       const cv::Mat      image ) {
+	boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+	if( this->headlessFlag || this->stopping ) { return ; }
+	if( !this->renderThread.joinable() ) {
+		this->renderThread = boost::thread( &VisualSink::renderThreadFunc, this ) ;
+	}
+	
+	// window of that name, added on first use
+	std::vector< Window >::iterator window = this->windows.begin() ;
+	while( window != this->windows.end() && window->name != name ) { ++window ; }
+	if( window == this->windows.end() ) {
+		Window added ;
+		added.name    = name ;
+		added.updated = false ;
+		this->windows.push_back( added ) ;
+		window = this->windows.end() - 1 ;
+	}
+	
+	// copy at most at the render rate
+	// developer note: Copying is needed as callers keep drawing into their images, but re-uses the window's buffer.
+	const boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time() ;
+	if( !window->timeCopied.is_not_a_date_time()
+	 && ( now - window->timeCopied ).total_microseconds() < 1e6 / this->rate ) {
+		return ;
+	}
+	image.copyTo( window->image ) ;
+	window->updated    = true ;
+	window->timeCopied = now ;
+}
+
+// oldest key pressed without waiting
+int VisualSink::pollKey() {
+	boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+	if( this->keys.empty() ) { return -1 ; }
+	const int key = this->keys.front() ;
+	this->keys.pop_front() ;
+	return key ;
+}
+
+// oldest key pressed, waiting for one up to the given time
+int VisualSink::waitKey( const int delayMs ) {
+	boost::unique_lock< boost::mutex > lock( this->mutex ) ;
+	if( this->headlessFlag ) { return -1 ; }
+	const boost::system_time timeout = boost::get_system_time() + boost::posix_time::milliseconds( delayMs ) ;
+	while( this->keys.empty() && !this->stopping ) {
+		if( delayMs > 0 ) {
+			if( !this->keyPressed.timed_wait( lock, timeout ) ) { break ; }
+		}
+		else {
+			this->keyPressed.wait( lock ) ;
+		}
+	}
+	if( this->keys.empty() ) { return -1 ; }
+	const int key = this->keys.front() ;
+	this->keys.pop_front() ;
+	return key ;
+}
+
+// show updated windows, then let "HighGUI" process events until the next period
+// developer note: All "HighGUI" calls happen on this thread, as most of its backends are not thread-safe.
+void VisualSink::renderThreadFunc() {
+	std::vector< Window > shown ;
+	while( true ) {
+		double periodMs ;
+		{
+			boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+			if( this->stopping ) { break ; }
+			periodMs = 1000.0 / this->rate ;
+			shown.resize( this->windows.size() ) ;
+			for( size_t window = 0 ; window < this->windows.size() ; ++window ) {
+				shown[ window ].updated = this->windows[ window ].updated ;
+				if( !this->windows[ window ].updated ) { continue ; }
+				shown[ window ].name = this->windows[ window ].name ;
+				std::swap( shown[ window ].image, this->windows[ window ].image ) ;
+				this->windows[ window ].updated = false ;
+			}
+		}
+		
+		// render outside the lock
+		for( size_t window = 0 ; window < shown.size() ; ++window ) {
+			if( shown[ window ].updated ) {
+				cv::imshow( shown[ window ].name, shown[ window ].image ) ;
+			}
+		}
+		int key = -1 ;
+		if( shown.empty() ) {
+			boost::this_thread::sleep( boost::posix_time::milliseconds( (int)periodMs ) ) ;
+		}
+		else {
+			key = cv::waitKey( std::max( 1, (int)periodMs ) ) ;
+		}
+		if( key >= 0 ) {
+			{
+				boost::lock_guard< boost::mutex > lock( this->mutex ) ;
+				if( this->keys.size() == keysMax ) { this->keys.pop_front() ; }
+				this->keys.push_back( key ) ;
+			}
+			this->keyPressed.notify_all() ;
+		}
+	}
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2013 by:- Institut Eurécom
+//                       - Télécom ParisTech
+// 
+// This file is part of demoARDrone.
+// 
+// demoARDrone is free software: you can redistribute it and/or modify it under the terms of the GNU General Public 
+// License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later 
+// version.
+// 
+// demoARDrone is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License along with libHawaii. If not, see 
+// <http://www.gnu.org/licenses/>.
+
+
+// visualization on its own thread at a capped rate
+// =================================================
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+
+// show a "cv::Mat" via the sink, named after the variable as with "HAWAII_IMSHOW()"
+#define VISUAL_SHOW( cvMat ) { VisualSink::instance().show( #cvMat, cvMat ) ; }
+
+// process-wide sink for debug windows: Processing code publishes images without blocking, a dedicated thread shows the
+//                                      latest image of each window at most "rate" times per second and collects key
+//                                      presses. Images arriving faster than that are not even copied.
+// user note: In headless mode - to be set before the first image is published - no thread is started, no window is
+//            opened and publishing returns at once, which is what drones without a display should run with.
+class VisualSink {
+	
+	// the single instance, created on first use
+	public:
+	static VisualSink& instance() ;
+	
+	// c'tor, d'tor to stop and join the render thread
+	protected:
+	VisualSink() ;
+	public:
+	~VisualSink() ;
+	
+	// non-copyable because of the owned thread
+	private:
+	VisualSink(             const VisualSink& ) ;
+	VisualSink& operator =( const VisualSink& ) ;
+	
+	// settings: headless mode, maximum number of updates per second
+	public:
+	void setHeadless( const bool   headlessArg ) ;
+	bool headless() const ;
+	void setRate(     const double rateArg ) ;
+	protected:
+	bool   headlessFlag ;
+	double rate ;
+	
+	// publish the latest image of a window, copied unless the window was updated less than a period ago
+	public:
+	void show( const std::string& name,
+	           const cv::Mat      image ) ;
+	protected:
+	struct Window {
+		std::string              name ;
+		cv::Mat                  image ;
+		bool                     updated ; // newer than the one shown
+		boost::posix_time::ptime timeCopied ;
+	} ;
+	std::vector< Window > windows ;
+	
+	// keys pressed in any window: oldest one without waiting, or waiting up to the given time (0 for no limit)
+	// user note: Both return -1 if there is none, "waitKey()" immediately so in headless mode.
+	public:
+	int pollKey() ;
+	int waitKey( const int delayMs ) ;
+	protected:
+	std::deque< int > keys ;
+	static const size_t keysMax = 16 ;
+	
+	// render thread and its synchronization
+	protected:
+	void renderThreadFunc() ;
+	bool                      stopping ;
+	mutable boost::mutex      mutex ;
+	boost::condition_variable keyPressed ;
+	boost::thread             renderThread ;
+
+} ; // class "VisualSink"